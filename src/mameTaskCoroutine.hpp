@@ -0,0 +1,347 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Fixed-capacity pool of equally sized blocks for coroutine frames
+ *
+ * Blocks are handed out from a free list, so allocation and release are O(1)
+ * and no heap is used. Not thread safe; frames are created and destroyed from
+ * the task loop only.
+ *
+ * @tparam BlockBytes The size of each block
+ * @tparam Blocks The number of blocks
+ */
+template<std::size_t BlockBytes, std::size_t Blocks>
+class CoroutineArena
+{
+private:
+  union Block
+  {
+    Block* next;
+    alignas(std::max_align_t) std::byte storage[BlockBytes];
+  };
+
+  static inline Block  blocks[Blocks];
+  static inline Block* free_blocks = nullptr;
+  static inline bool   initialized = false;
+
+public:
+  // Static RAM reserved by the arena
+  static constexpr std::size_t storage_bytes = sizeof(Block) * Blocks;
+
+  /**
+   * @brief Takes a block, or returns nullptr if size does not fit or the arena is exhausted
+   */
+  static void* allocate(std::size_t size) noexcept
+  {
+    if (!initialized)
+    {
+      for (Block& block : blocks)
+      {
+        block.next  = free_blocks;
+        free_blocks = &block;
+      }
+      initialized = true;
+    }
+    if (size > BlockBytes || !free_blocks)
+    {
+      return nullptr;
+    }
+    Block* block = free_blocks;
+    free_blocks  = block->next;
+    return block;
+  }
+
+  /**
+   * @brief Returns a block obtained from allocate
+   */
+  static void release(void* pointer) noexcept
+  {
+    Block* block = static_cast<Block*>(pointer);
+    block->next  = free_blocks;
+    free_blocks  = block;
+  }
+};
+
+/**
+ * @brief One-shot event a coroutine task can co_await
+ *
+ * signal() is lock-free and safe to call from an ISR, the other core or a
+ * timer task. A signal with no waiter is remembered, so the next co_await
+ * completes immediately; several signals before a wakeup count as one.
+ */
+class TaskEvent
+{
+private:
+  std::atomic<bool>                         signalled{ false };
+  std::atomic<async_context_t*>             context{ nullptr };
+  std::atomic<async_when_pending_worker_t*> waiter{ nullptr };
+
+public:
+  TaskEvent() = default;
+
+  // Waiters refer to the event, so it must stay in place
+  TaskEvent(const TaskEvent&)            = delete;
+  TaskEvent& operator=(const TaskEvent&) = delete;
+
+  /**
+   * @brief Wakes the waiting coroutine, or the next one to co_await the event
+   */
+  void signal()
+  {
+    signalled.store(true);
+    async_when_pending_worker_t* worker = waiter.load();
+    if (worker)
+    {
+      async_context_set_work_pending(context.load(), worker);
+    }
+  }
+
+  /**
+   * @brief Consumes a pending signal
+   *
+   * @return true if the event had been signalled
+   */
+  bool consume() { return signalled.exchange(false); }
+
+  bool await_ready() { return consume(); }
+
+  template<typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle)
+  {
+    Promise& promise = handle.promise();
+    promise.awaited_event = this;
+    context.store(promise.context);
+    waiter.store(&promise.wake);
+    // A signal that raced with registering must not be lost
+    if (signalled.load())
+    {
+      async_context_set_work_pending(promise.context, &promise.wake);
+    }
+  }
+
+  void await_resume() {}
+
+  /**
+   * @brief Detaches the waiter; called when the coroutine resumes
+   */
+  void clear_waiter() { waiter.store(nullptr); }
+};
+
+/**
+ * @brief Awaitable that resumes a coroutine task at an absolute time
+ */
+struct ResumeAt
+{
+  absolute_time_t time;
+
+  bool await_ready() const noexcept { return false; }
+
+  template<typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) const
+  {
+    Promise& promise = handle.promise();
+    async_context_add_at_time_worker_at(promise.context, &promise.timer, time);
+  }
+
+  void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Suspends a coroutine task for the given duration
+ *
+ * @param duration How long to sleep, with microsecond resolution; a negative duration sleeps for 0
+ * @return An awaitable for co_await
+ */
+template<typename Rep, typename Period>
+ResumeAt sleep_for(std::chrono::duration<Rep, Period> duration)
+{
+  int64_t const us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  return ResumeAt{ make_timeout_time_us(us > 0 ? static_cast<uint64_t>(us) : 0) };
+}
+
+/**
+ * @brief Suspends a coroutine task for the given number of milliseconds
+ *
+ * @param ms How long to sleep in milliseconds
+ * @return An awaitable for co_await
+ */
+inline ResumeAt sleep_for(unsigned ms)
+{
+  return sleep_for(std::chrono::milliseconds{ ms });
+}
+
+/**
+ * @brief Suspends a coroutine task until the next poll
+ *
+ * @return An awaitable for co_await
+ */
+inline ResumeAt next_tick()
+{
+  return ResumeAt{ get_absolute_time() };
+}
+
+/**
+ * @brief Task whose body is a C++20 coroutine
+ *
+ * A function returning BasicCoroutineTask may co_await sleep_for(),
+ * next_tick() and a TaskEvent, so multi-step sequences are written as
+ * straight-line code instead of state machines. The body starts on the first
+ * poll after the task is attached to a TaskRunner and resumes from the
+ * runner's poll. Frames come from a static CoroutineArena; if the frame does
+ * not fit or the arena is exhausted, the task is created empty (valid() is
+ * false) and never runs.
+ *
+ * @tparam FrameBytes The maximum coroutine frame size
+ * @tparam MaxFrames The maximum number of live coroutine tasks of this type
+ */
+template<std::size_t FrameBytes, std::size_t MaxFrames>
+class BasicCoroutineTask
+{
+public:
+  using Arena = CoroutineArena<FrameBytes, MaxFrames>;
+
+  struct promise_type : RunReporter
+  {
+    async_at_time_worker_t      timer{};
+    async_when_pending_worker_t wake{};
+    async_context_t*            context       = nullptr;
+    TaskEvent*                  awaited_event = nullptr;
+
+    promise_type()
+    {
+      timer.do_work   = resume_from_timer;
+      timer.user_data = this;
+      wake.do_work    = resume_from_event;
+      wake.user_data  = this;
+    }
+
+    static void resume_from_timer(async_context_t*, async_at_time_worker_t* worker)
+    {
+      auto* promise = static_cast<promise_type*>(worker->user_data);
+      promise->report_run();
+      std::coroutine_handle<promise_type>::from_promise(*promise).resume();
+    }
+
+    static void resume_from_event(async_context_t*, async_when_pending_worker_t* worker)
+    {
+      auto* promise = static_cast<promise_type*>(worker->user_data);
+      // Spurious or already consumed wakeups leave the coroutine waiting
+      if (!promise->awaited_event || !promise->awaited_event->consume())
+      {
+        return;
+      }
+      promise->awaited_event->clear_waiter();
+      promise->awaited_event = nullptr;
+      promise->report_run();
+      std::coroutine_handle<promise_type>::from_promise(*promise).resume();
+    }
+
+    static void* operator new(std::size_t size) noexcept { return Arena::allocate(size); }
+    static void  operator delete(void* pointer) noexcept { Arena::release(pointer); }
+
+    static BasicCoroutineTask get_return_object_on_allocation_failure() { return BasicCoroutineTask(nullptr); }
+    BasicCoroutineTask        get_return_object()
+    {
+      return BasicCoroutineTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void                return_void() {}
+    void                unhandled_exception() { std::terminate(); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle;
+
+  explicit BasicCoroutineTask(std::coroutine_handle<promise_type> handle)
+    : handle(handle)
+  {
+  }
+
+public:
+  BasicCoroutineTask(BasicCoroutineTask&& other) noexcept
+    : handle(other.handle)
+  {
+    other.handle = nullptr;
+  }
+  BasicCoroutineTask& operator=(BasicCoroutineTask&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  BasicCoroutineTask(const BasicCoroutineTask&)            = delete;
+  BasicCoroutineTask& operator=(const BasicCoroutineTask&) = delete;
+
+  ~BasicCoroutineTask()
+  {
+    if (!handle)
+    {
+      return;
+    }
+    promise_type& promise = handle.promise();
+    if (promise.context)
+    {
+      async_context_remove_at_time_worker(promise.context, &promise.timer);
+      async_context_remove_when_pending_worker(promise.context, &promise.wake);
+    }
+    if (promise.awaited_event)
+    {
+      promise.awaited_event->clear_waiter();
+    }
+    handle.destroy();
+  }
+
+  /**
+   * @brief Adds the task to an async context; called by TaskRunner
+   *
+   * @param async_context The context whose poll runs the coroutine
+   */
+  void attach(async_context_t& async_context)
+  {
+    if (!handle)
+    {
+      return;
+    }
+    promise_type& promise = handle.promise();
+    promise.context       = &async_context;
+    async_context_add_when_pending_worker(promise.context, &promise.wake);
+    async_context_add_at_time_worker_in_ms(promise.context, &promise.timer, 0);
+  }
+
+  /**
+   * @brief Sets the meter that is told about each resumption; called by TaskRunner
+   *
+   * @param meter The load meter of the runner
+   */
+  void set_load_meter(LoadMeter* meter)
+  {
+    if (handle)
+    {
+      handle.promise().set_load_meter(meter);
+    }
+  }
+
+  /**
+   * @brief Checks whether the coroutine frame could be allocated
+   */
+  bool valid() const { return static_cast<bool>(handle); }
+
+  /**
+   * @brief Checks whether the coroutine body has returned
+   */
+  bool done() const { return handle && handle.done(); }
+};
+
+/**
+ * @brief Coroutine task with frames of up to 256 bytes and at most 8 live tasks
+ */
+using CoroutineTask = BasicCoroutineTask<256, 8>;
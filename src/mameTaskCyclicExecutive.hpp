@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Concept for tasks whose period is a compile-time constant and that can be run directly
+ *
+ * Satisfied by FixedPeriodTask, i.e. tasks created with create_scheduled_task<Interval>().
+ *
+ * @tparam T The type to check
+ */
+template<typename T>
+concept CyclicTask = requires(T t, absolute_time_t release) {
+  { T::period } -> std::convertible_to<std::chrono::microseconds>;
+  t.invoke(release);
+};
+
+/**
+ * @brief Time-triggered dispatcher driven by a schedule table computed at compile time
+ *
+ * The minor frame is the greatest common divisor of the task periods and the
+ * hyperperiod their least common multiple. For every minor frame of the
+ * hyperperiod, a static table holds the set of tasks released in it. Each
+ * tick runs the tasks of the current frame in the order they were passed to
+ * the constructor and moves to the next frame, so there is no timer queue and
+ * no async context. Frames that start late run back-to-back, keeping the table
+ * order, and those that end after the next frame should have started are
+ * counted as overruns.
+ *
+ * @tparam Tasks The task types; each must satisfy CyclicTask
+ */
+template<CyclicTask... Tasks>
+class CyclicExecutive
+{
+  static_assert(sizeof...(Tasks) > 0, "a cyclic executive needs at least one task");
+  static_assert(sizeof...(Tasks) <= 32, "a schedule table entry holds at most 32 tasks");
+  static_assert(((Tasks::period.count() > 0) && ...), "every task needs a non-zero period");
+
+  static constexpr std::array<uint64_t, sizeof...(Tasks)> periods_us{ static_cast<uint64_t>(Tasks::period.count())... };
+
+  static constexpr uint64_t gcd_of_periods()
+  {
+    uint64_t result = 0;
+    for (uint64_t period : periods_us)
+    {
+      result = std::gcd(result, period);
+    }
+    return result;
+  }
+
+  static constexpr uint64_t lcm_of_periods()
+  {
+    uint64_t result = 1;
+    for (uint64_t period : periods_us)
+    {
+      result = std::lcm(result, period);
+    }
+    return result;
+  }
+
+public:
+  // Upper bound on the table size, which is kept in flash
+  static constexpr std::size_t max_frames = 4096;
+
+  static constexpr std::chrono::microseconds minor_frame{ gcd_of_periods() };
+  static constexpr std::chrono::microseconds hyperperiod{ lcm_of_periods() };
+  static constexpr std::size_t               frames = hyperperiod / minor_frame;
+
+  static_assert(frames <= max_frames, "the hyperperiod spans too many minor frames; use harmonic periods");
+
+  // One bit per task, in constructor order
+  using Mask = std::conditional_t<(sizeof...(Tasks) <= 8),
+                                  uint8_t,
+                                  std::conditional_t<(sizeof...(Tasks) <= 16), uint16_t, uint32_t>>;
+
+  /**
+   * @brief Tasks released in each minor frame of the hyperperiod
+   */
+  static constexpr std::array<Mask, frames> schedule = []
+  {
+    std::array<Mask, frames> table{};
+    for (std::size_t frame = 0; frame < frames; frame++)
+    {
+      uint64_t const start = frame * static_cast<uint64_t>(minor_frame.count());
+      for (std::size_t i = 0; i < periods_us.size(); i++)
+      {
+        if (start % periods_us[i] == 0)
+        {
+          table[frame] |= static_cast<Mask>(1u << i);
+        }
+      }
+    }
+    return table;
+  }();
+
+private:
+  std::tuple<Tasks...> tasks;
+  absolute_time_t      frame_start;
+  std::size_t          frame          = 0;
+  uint32_t             frame_overruns = 0;
+
+  template<std::size_t... I>
+  void run_frame(Mask mask, std::index_sequence<I...>)
+  {
+    ((mask & (Mask{ 1 } << I) ? std::get<I>(tasks).invoke(frame_start) : void()), ...);
+  }
+
+public:
+  /**
+   * @brief Constructs a CyclicExecutive with the given tasks; the first frame starts immediately
+   *
+   * @param args The tasks to run
+   */
+  CyclicExecutive(Tasks&&... args)
+    : tasks(std::forward<Tasks>(args)...)
+    , frame_start(get_absolute_time())
+  {
+  }
+
+  // Prevent copying to avoid resource management issues
+  CyclicExecutive(const CyclicExecutive&)            = delete;
+  CyclicExecutive& operator=(const CyclicExecutive&) = delete;
+
+  /**
+   * @brief Runs the current minor frame and moves to the next one, whether or not it is due
+   *
+   * Suitable for calling from a periodic hardware timer.
+   */
+  void tick()
+  {
+    run_frame(schedule[frame], std::index_sequence_for<Tasks...>{});
+    frame_start = delayed_by_us(frame_start, minor_frame.count());
+    frame       = frame + 1 == frames ? 0 : frame + 1;
+    if (absolute_time_diff_us(frame_start, get_absolute_time()) > 0)
+    {
+      frame_overruns++;
+    }
+  }
+
+  /**
+   * @brief Runs the current minor frame if it has started
+   */
+  void poll()
+  {
+    if (time_reached(frame_start))
+    {
+      tick();
+    }
+  }
+
+  /**
+   * @brief Gets the start of the next minor frame to run
+   *
+   * @return The absolute time at which the next frame is due
+   */
+  absolute_time_t get_next_deadline() const { return frame_start; }
+
+  /**
+   * @brief Gets the index of the next minor frame to run within the hyperperiod
+   */
+  std::size_t get_frame() const { return frame; }
+
+  /**
+   * @brief Gets the number of frames that ended after the following frame should have started
+   */
+  uint32_t get_frame_overruns() const { return frame_overruns; }
+
+  /**
+   * @brief Sleeps until the next frame starts or the timeout expires
+   *
+   * @param until Absolute time after which to return even if no frame is due
+   */
+  void wait_for_work_until(absolute_time_t until)
+  {
+    sleep_until(absolute_time_diff_us(frame_start, until) < 0 ? until : frame_start);
+  }
+
+  /**
+   * @brief Gets a task owned by the executive
+   *
+   * @tparam I Index of the task in the order it was passed to the constructor
+   * @return Reference to the task
+   */
+  template<std::size_t I>
+  auto& get_task()
+  {
+    return std::get<I>(tasks);
+  }
+
+  /**
+   * @brief Runs the frames indefinitely, sleeping between them
+   */
+  void run_forever()
+  {
+    while (true)
+    {
+      wait_for_work_until(at_the_end_of_time);
+      poll();
+    }
+  }
+};
@@ -0,0 +1,613 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <pico/multicore.h>
+
+#include "mameTaskPico.hpp"
+#include "mameTaskQueue.hpp"
+
+/**
+ * @brief Small type-erased job that can be copied between cores
+ *
+ * Holds a trivially copyable callable by value next to the function that
+ * invokes it, so the whole job can be copied bytewise through a queue.
+ *
+ * @tparam JobBytes Largest callable the job can hold
+ */
+template<std::size_t JobBytes>
+struct CoreJob
+{
+  void (*invoke)(void* storage) = nullptr;
+  alignas(std::max_align_t) unsigned char storage[JobBytes];
+
+  /**
+   * @brief Wraps a callable in a job
+   *
+   * @param callable A trivially copyable callable, e.g. a lambda capturing pointers and integers
+   */
+  template<typename F>
+    requires TaskCallable<std::decay_t<F>>
+  static CoreJob make(F&& callable)
+  {
+    using Callable = std::decay_t<F>;
+    static_assert(std::is_trivially_copyable_v<Callable>, "jobs are copied between cores; capture pointers, not objects");
+    static_assert(sizeof(Callable) <= JobBytes, "the job does not fit; raise JobBytes");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "the job is over-aligned");
+
+    CoreJob job;
+    job.invoke = [](void* storage) { (*reinterpret_cast<Callable*>(storage))(); };
+    ::new (static_cast<void*>(job.storage)) Callable(std::forward<F>(callable));
+    return job;
+  }
+
+  /**
+   * @brief Runs the callable
+   */
+  void run() { invoke(storage); }
+};
+
+/**
+ * @brief Task that runs jobs posted to its runner from the other core, an ISR or another thread
+ *
+ * Jobs are small trivially copyable callables, stored by value in an
+ * MpscQueue. Each post marks the mailbox pending in its runner's async
+ * context, waking that core if it sleeps, and the runner's next poll runs the
+ * queued jobs in the order they were posted. Add one to a TaskRunner like any
+ * other task.
+ *
+ * @tparam Capacity Maximum number of queued jobs; a power of two
+ * @tparam JobBytes Largest callable a job can hold
+ */
+template<std::size_t Capacity = 16, std::size_t JobBytes = 16>
+class CoreMailbox : public PendingWorkerTask<CoreMailbox<Capacity, JobBytes>>
+{
+  using Job = CoreJob<JobBytes>;
+
+  friend class PendingWorkerTask<CoreMailbox>;
+
+  MpscQueue<Job, Capacity> jobs;
+
+  void run_pending()
+  {
+    this->report_run();
+    jobs.drain([](Job job) { job.run(); });
+  }
+
+public:
+  static constexpr bool is_core_mailbox = true;
+
+  CoreMailbox() { jobs.set_consumer(*this); }
+
+  /**
+   * @brief Move constructor; mailboxes must be moved before they are attached
+   */
+  CoreMailbox(CoreMailbox&& other)
+    : PendingWorkerTask<CoreMailbox>(std::move(other))
+  {
+    jobs.set_consumer(*this);
+    Job job;
+    while (other.jobs.pop(job))
+    {
+      jobs.push(job);
+    }
+  }
+  CoreMailbox& operator=(CoreMailbox&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  CoreMailbox(const CoreMailbox&)            = delete;
+  CoreMailbox& operator=(const CoreMailbox&) = delete;
+
+  /**
+   * @brief Queues a job to run on the mailbox's core
+   *
+   * Lock-free apart from the compare-and-swap of MpscQueue, and safe to call
+   * from any core, ISR or thread.
+   *
+   * @param job A trivially copyable callable, e.g. a lambda capturing pointers and integers
+   * @return false if the mailbox is full
+   */
+  template<typename F>
+    requires TaskCallable<std::decay_t<F>>
+  bool post(F&& job)
+  {
+    return jobs.push(Job::make(std::forward<F>(job)));
+  }
+};
+
+/**
+ * @brief Task that runs a burst of one-shot jobs, which an idle core can steal
+ *
+ * A bounded Chase-Lev deque. Its owning core pushes ready jobs at the bottom
+ * and runs them from the bottom, one per poll, so the runner's periodic tasks
+ * still run between jobs. The other core steals from the top when it has
+ * nothing else to do. Only the last job is contended: the owner and the thief
+ * race for it with a compare-and-swap. Slots are copied word by word with
+ * relaxed atomics, because a thief may read a slot that it then fails to
+ * claim.
+ *
+ * Add one to a runner of a DualCoreRunner and push jobs with
+ * DualCoreRunner::push_job(), which also wakes the other core if it sleeps.
+ *
+ * @tparam Capacity Maximum number of queued jobs; a power of two
+ * @tparam JobBytes Largest callable a job can hold
+ */
+template<std::size_t Capacity = 32, std::size_t JobBytes = 16>
+class JobDeque : public PendingWorkerTask<JobDeque<Capacity, JobBytes>>
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+  static_assert(Capacity <= (std::size_t{ 1 } << 31), "the capacity must fit in a 32-bit index");
+
+  using Job = CoreJob<JobBytes>;
+
+  friend class PendingWorkerTask<JobDeque>;
+
+  static constexpr uint32_t    mask  = Capacity - 1;
+  static constexpr std::size_t words = sizeof(Job) / sizeof(uintptr_t);
+  static_assert(sizeof(Job) % sizeof(uintptr_t) == 0, "jobs are copied in whole words");
+
+  struct Slot
+  {
+    std::atomic<uintptr_t> word[words];
+  };
+
+  alignas(MAMETASK_QUEUE_ALIGN) std::atomic<uint32_t> top{ 0 };     // advanced by both cores
+  alignas(MAMETASK_QUEUE_ALIGN) std::atomic<uint32_t> bottom{ 0 };  // written by the owner
+  alignas(MAMETASK_QUEUE_ALIGN) Slot slots[Capacity];
+
+  void store(uint32_t index, const Job& job)
+  {
+    uintptr_t bytes[words];
+    std::memcpy(bytes, &job, sizeof(Job));
+    for (std::size_t w = 0; w < words; w++)
+    {
+      slots[index & mask].word[w].store(bytes[w], std::memory_order_relaxed);
+    }
+  }
+
+  Job load(uint32_t index) const
+  {
+    uintptr_t bytes[words];
+    for (std::size_t w = 0; w < words; w++)
+    {
+      bytes[w] = slots[index & mask].word[w].load(std::memory_order_relaxed);
+    }
+    Job job;
+    std::memcpy(&job, bytes, sizeof(Job));
+    return job;
+  }
+
+  // Takes the newest job; owner only
+  bool take(Job& job)
+  {
+    const uint32_t b = bottom.load(std::memory_order_relaxed) - 1;
+    // Sequentially consistent so that a thief sees the reservation before we read top
+    bottom.store(b, std::memory_order_seq_cst);
+    uint32_t t = top.load(std::memory_order_seq_cst);
+    if (static_cast<int32_t>(b - t) < 0)
+    {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    job = load(b);
+    if (b != t)
+    {
+      return true;
+    }
+    // The last job: race a thief for it
+    const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  // Takes the oldest job; any core
+  bool steal(Job& job)
+  {
+    uint32_t       t = top.load(std::memory_order_seq_cst);
+    const uint32_t b = bottom.load(std::memory_order_seq_cst);
+    if (static_cast<int32_t>(b - t) <= 0)
+    {
+      return false;
+    }
+    job = load(t);
+    // Fails if the owner or another thief claimed the job first; the copy is discarded
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  void run_pending()
+  {
+    Job job;
+    if (take(job))
+    {
+      this->report_run();
+      job.run();
+    }
+    // One job per poll keeps the runner's timers on schedule
+    if (!empty())
+    {
+      this->signal();
+    }
+  }
+
+public:
+  static constexpr bool is_job_deque = true;
+
+  JobDeque() = default;
+
+  /**
+   * @brief Move constructor; deques must be moved before they are attached
+   */
+  JobDeque(JobDeque&& other)
+    : PendingWorkerTask<JobDeque>(std::move(other))
+    , top(other.top.load(std::memory_order_relaxed))
+    , bottom(other.bottom.load(std::memory_order_relaxed))
+  {
+    for (uint32_t i = top.load(std::memory_order_relaxed); i != bottom.load(std::memory_order_relaxed); i++)
+    {
+      store(i, other.load(i));
+    }
+  }
+  JobDeque& operator=(JobDeque&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  JobDeque(const JobDeque&)            = delete;
+  JobDeque& operator=(const JobDeque&) = delete;
+
+  /**
+   * @brief Queues a ready job; call only on the owning core
+   *
+   * @param job A trivially copyable callable, e.g. a lambda capturing pointers and integers
+   * @return false if the deque is full
+   */
+  template<typename F>
+    requires TaskCallable<std::decay_t<F>>
+  bool push(F&& job)
+  {
+    const uint32_t b = bottom.load(std::memory_order_relaxed);
+    const uint32_t t = top.load(std::memory_order_acquire);
+    if (b - t >= Capacity)
+    {
+      return false;
+    }
+    store(b, Job::make(std::forward<F>(job)));
+    // Sequentially consistent so that DualCoreRunner can check for an idle thief afterwards
+    bottom.store(b + 1, std::memory_order_seq_cst);
+    this->signal();
+    return true;
+  }
+
+  /**
+   * @brief Steals the oldest job and runs it on the calling core
+   *
+   * @param thief The load meter of the calling core's runner, told about the run
+   * @return true if a job was run
+   */
+  bool run_stolen(LoadMeter* thief = nullptr)
+  {
+    Job job;
+    if (!steal(job))
+    {
+      return false;
+    }
+    if (thief)
+    {
+      thief->run_started();
+    }
+    job.run();
+    return true;
+  }
+
+  /**
+   * @brief Gets the number of queued jobs; only a snapshot while the other core steals
+   */
+  std::size_t size() const
+  {
+    const uint32_t b = bottom.load(std::memory_order_acquire);
+    const uint32_t t = top.load(std::memory_order_acquire);
+    return static_cast<int32_t>(b - t) > 0 ? b - t : 0;
+  }
+
+  /**
+   * @brief Checks whether no jobs are queued
+   */
+  bool empty() const { return size() == 0; }
+};
+
+/**
+ * @brief Concept for the mailbox task of a runner
+ */
+template<typename T>
+concept MailboxTask = requires { requires T::is_core_mailbox; };
+
+/**
+ * @brief Concept for the job deque task of a runner
+ */
+template<typename T>
+concept JobDequeTask = requires { requires T::is_job_deque; };
+
+/**
+ * @brief Indices of the first CoreMailbox and the first JobDeque among the tasks of a runner
+ */
+template<typename Runner>
+struct runner_tasks;
+
+template<typename... Tasks>
+struct runner_tasks<TaskRunner<Tasks...>>
+{
+private:
+  static constexpr std::size_t first(std::initializer_list<bool> matches)
+  {
+    std::size_t i = 0;
+    for (bool match : matches)
+    {
+      if (match)
+      {
+        return i;
+      }
+      i++;
+    }
+    return i;
+  }
+
+public:
+  static constexpr std::size_t mailbox     = first({ MailboxTask<Tasks>... });
+  static constexpr std::size_t deque       = first({ JobDequeTask<Tasks>... });
+  static constexpr bool        has_mailbox = mailbox < sizeof...(Tasks);
+  static constexpr bool        has_deque   = deque < sizeof...(Tasks);
+};
+
+/**
+ * @brief Runs two TaskRunners side by side, one on each core
+ *
+ * Each runner keeps its own async context and its own pinned tasks, and is
+ * used exactly like a single-core TaskRunner. Core 1's runner must include a
+ * CoreMailbox, which carries posted jobs and the request to stop; a mailbox
+ * on core 0's runner is optional and enables posting to core 0. Work moves
+ * between cores by posting a job, e.g. one that spawns a task in the target
+ * core's TaskPool.
+ *
+ * Bursts of one-shot jobs go to a JobDeque on the producing core's runner.
+ * Before sleeping, a core whose runner has a mailbox steals one job at a time
+ * from the other core's deque, so both cores share the burst while their
+ * periodic tasks keep running between jobs.
+ *
+ * Construct both runners on core 0 before launching core 1, and only touch a
+ * runner's tasks from its own core (or through its mailbox) afterwards.
+ *
+ * @tparam Runner0 The TaskRunner type for core 0
+ * @tparam Runner1 The TaskRunner type for core 1
+ */
+template<typename Runner0, typename Runner1>
+class DualCoreRunner
+{
+  static_assert(runner_tasks<Runner1>::has_mailbox, "the core 1 runner needs a CoreMailbox");
+
+  Runner0&          core0;
+  Runner1&          core1;
+  std::atomic<bool> stop_requested{ false };
+  std::atomic<bool> core1_running{ false };
+  // Set while a core is about to sleep, so that push_job() knows to wake it
+  std::atomic<bool> idle[2] = { false, false };
+
+  // multicore_launch_core1 takes no argument; there is only one core 1
+  static inline DualCoreRunner* launched = nullptr;
+
+  static void core1_entry()
+  {
+    DualCoreRunner* const self = launched;
+    while (!self->stop_requested.load(std::memory_order_acquire))
+    {
+      self->run_once<1>();
+    }
+    self->core1_running.store(false, std::memory_order_release);
+  }
+
+  template<unsigned Core>
+  using RunnerOf = std::conditional_t<Core == 0, Runner0, Runner1>;
+
+  // A core steals if the other core has a deque and it can be woken through its own mailbox
+  template<unsigned Core>
+  static constexpr bool can_steal = runner_tasks<RunnerOf<Core>>::has_mailbox && runner_tasks<RunnerOf<1 - Core>>::has_deque;
+
+  // Polls a core's runner, then steals a job or sleeps until there is work
+  template<unsigned Core>
+  void run_once()
+  {
+    auto& runner = get_runner<Core>();
+    runner.poll();
+    if constexpr (can_steal<Core>)
+    {
+      if (steal<Core>())
+      {
+        return;
+      }
+      // Announce the sleep, then look once more so that a concurrent push is not missed
+      idle[Core].store(true, std::memory_order_seq_cst);
+      if (!steal<Core>())
+      {
+        runner.wait_for_work_until(at_the_end_of_time);
+      }
+      idle[Core].store(false, std::memory_order_relaxed);
+    }
+    else
+    {
+      runner.wait_for_work_until(at_the_end_of_time);
+    }
+  }
+
+public:
+  /**
+   * @brief Pairs a runner for each core
+   *
+   * @param runner0 The runner to run on core 0, i.e. the calling core
+   * @param runner1 The runner to run on core 1
+   */
+  DualCoreRunner(Runner0& runner0, Runner1& runner1)
+    : core0(runner0)
+    , core1(runner1)
+  {
+  }
+
+  // The core 1 loop refers to this object
+  DualCoreRunner(const DualCoreRunner&)            = delete;
+  DualCoreRunner& operator=(const DualCoreRunner&) = delete;
+
+  ~DualCoreRunner() { stop_core1(); }
+
+  /**
+   * @brief Starts core 1's runner loop; core 0 keeps running the caller
+   */
+  void launch_core1()
+  {
+    if (core1_running.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    stop_requested.store(false, std::memory_order_relaxed);
+    core1_running.store(true, std::memory_order_release);
+    launched = this;
+    multicore_launch_core1(core1_entry);
+  }
+
+  /**
+   * @brief Stops core 1's runner loop after its current poll and waits for it to finish
+   */
+  void stop_core1()
+  {
+    if (!core1_running.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    stop_requested.store(true, std::memory_order_release);
+    // Wakes the loop if it sleeps
+    while (!post<1>([]() {}) && core1_running.load(std::memory_order_acquire))
+    {
+    }
+    while (core1_running.load(std::memory_order_acquire))
+    {
+    }
+    multicore_reset_core1();
+    launched = nullptr;
+  }
+
+  /**
+   * @brief Checks whether core 1's runner loop is running
+   */
+  bool is_core1_running() const { return core1_running.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Queues a job to run on a core
+   *
+   * @tparam Core 0 or 1; the core's runner needs a CoreMailbox
+   * @param job A trivially copyable callable
+   * @return false if the mailbox is full
+   */
+  template<unsigned Core, typename F>
+  bool post(F&& job)
+  {
+    static_assert(Core < 2, "the RP2040 has two cores");
+    using Tasks = runner_tasks<RunnerOf<Core>>;
+    static_assert(Tasks::has_mailbox, "the runner of that core has no CoreMailbox");
+    return get_runner<Core>().template get_task<Tasks::mailbox>().post(std::forward<F>(job));
+  }
+
+  /**
+   * @brief Queues a one-shot job on a core's JobDeque; call only on that core
+   *
+   * The job runs on a later poll of the core, unless the other core steals it
+   * first. Wakes the other core if it sleeps and can steal.
+   *
+   * @tparam Core The calling core, 0 or 1; its runner needs a JobDeque
+   * @param job A trivially copyable callable
+   * @return false if the deque is full
+   */
+  template<unsigned Core, typename F>
+  bool push_job(F&& job)
+  {
+    static_assert(Core < 2, "the RP2040 has two cores");
+    using Tasks = runner_tasks<RunnerOf<Core>>;
+    static_assert(Tasks::has_deque, "the runner of that core has no JobDeque");
+    if (!get_runner<Core>().template get_task<Tasks::deque>().push(std::forward<F>(job)))
+    {
+      return false;
+    }
+    if constexpr (can_steal<1 - Core>)
+    {
+      if (idle[1 - Core].load(std::memory_order_seq_cst))
+      {
+        using Thief = runner_tasks<RunnerOf<1 - Core>>;
+        get_runner<1 - Core>().template get_task<Thief::mailbox>().signal();
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Runs one job stolen from the other core's JobDeque
+   *
+   * Called by the runner loops before they sleep; call it from a custom loop
+   * on core `Core` when it is idle. The job counts as a run of core `Core`'s
+   * runner in its CPU load.
+   *
+   * @tparam Core The calling core, 0 or 1
+   * @return true if a job was run
+   */
+  template<unsigned Core>
+  bool steal()
+  {
+    static_assert(Core < 2, "the RP2040 has two cores");
+    using Victim = runner_tasks<RunnerOf<1 - Core>>;
+    if constexpr (Victim::has_deque)
+    {
+      auto& victim = get_runner<1 - Core>().template get_task<Victim::deque>();
+      return get_runner<Core>().run_metered([&victim](LoadMeter& thief) { return victim.run_stolen(&thief); });
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Gets the runner pinned to a core
+   *
+   * @tparam Core 0 or 1
+   */
+  template<unsigned Core>
+  auto& get_runner()
+  {
+    static_assert(Core < 2, "the RP2040 has two cores");
+    if constexpr (Core == 0)
+    {
+      return core0;
+    }
+    else
+    {
+      return core1;
+    }
+  }
+
+  /**
+   * @brief Polls core 0's runner once
+   */
+  void poll() { core0.poll(); }
+
+  /**
+   * @brief Launches core 1 and runs core 0's loop indefinitely, stealing jobs when idle
+   */
+  void run_forever()
+  {
+    launch_core1();
+    while (true)
+    {
+      run_once<0>();
+    }
+  }
+};
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <numeric>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -29,137 +34,1995 @@ concept ScheduledTaskInterface = requires(T t) {
   { t.get_native_worker() } -> std::same_as<async_at_time_worker_t&>;
 };
 
+/**
+ * @brief Concept for tasks that register themselves with an async context
+ *
+ * Requires an attach method that adds the task's workers to the context. Used
+ * by task types that are not plain at-time workers, such as EventTask.
+ */
+template<typename T>
+concept AttachableTask = requires(T t, async_context_t& context) {
+  { t.attach(context) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Concept for attachable tasks that can take their workers off a context again
+ *
+ * Used by TaskRunner to leave a context that outlives it. Attachable tasks
+ * without a detach method remove their workers in their destructors.
+ */
+template<typename T>
+concept DetachableTask = AttachableTask<T> && requires(T t, async_context_t& context) {
+  { t.detach(context) } -> std::same_as<void>;
+};
+
+class LoadMeter;
+
+/**
+ * @brief Concept for tasks that report their runs to the runner's load meter
+ *
+ * The runner passes its meter, which the task tells about each run (see
+ * RunReporter), so that polls in which none of its tasks ran take no
+ * timestamps and count as idle.
+ */
+template<typename T>
+concept RunReportingTask = requires(T t, LoadMeter* meter) {
+  { t.set_load_meter(meter) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Concept for any type that a TaskRunner can host
+ */
+template<typename T>
+concept RunnableTask = ScheduledTaskInterface<T> || AttachableTask<T>;
+
+/**
+ * @brief How a periodic task computes its next deadline
+ *
+ * relative reschedules one period after the callback returns, so every
+ * period slips by the callback runtime and the poll lateness. The other
+ * policies anchor to absolute deadlines (next = previous deadline + period)
+ * and only differ in how missed deadlines are handled.
+ */
+enum class SchedulePolicy : uint8_t
+{
+  relative,  ///< next = completion time + period
+  skip,      ///< drop missed periods and resume at the next deadline on the grid
+  run_once,  ///< run once for all missed periods, then resume on the grid
+  burst,     ///< run back-to-back until every missed period has been served
+};
+
+/**
+ * @brief Concept for tasks whose runs can be deferred and ordered by the runner
+ *
+ * Instead of running inside the async context poll, a deferred task sets its
+ * bit in the runner's ready mask; the runner then calls run() in dispatch order.
+ */
+template<typename T>
+concept PrioritizedTask = ScheduledTaskInterface<T> && requires(T t, async_context_t* context, uint32_t* ready_tasks) {
+  { t.get_priority() } -> std::convertible_to<uint8_t>;
+  { t.get_absolute_deadline() } -> std::convertible_to<absolute_time_t>;
+  t.defer_to(ready_tasks, uint32_t{}, bool{});
+  t.run(context);
+};
+
+/**
+ * @brief Concept for timer tasks with a period, whose first release can be shifted
+ */
+template<typename T>
+concept PeriodicTask = ScheduledTaskInterface<T> && requires(T t) {
+  { t.get_period() } -> std::convertible_to<std::chrono::microseconds>;
+};
+
+/**
+ * @brief Order in which a TaskRunner dispatches tasks that are due in the same poll
+ */
+enum class DispatchMode : uint8_t
+{
+  fifo,      ///< (default) deadline and insertion order, as the async context runs them
+  priority,  ///< highest priority first, re-checking for newly due tasks after each run
+  edf,       ///< earliest absolute deadline (release + relative deadline) first, re-checking likewise
+};
+
+/**
+ * @brief Measurements of a run that exceeded its execution budget or started too late
+ */
+struct TimingViolation
+{
+  uint8_t  task_id;       ///< index of the task in its TaskRunner
+  bool     overrun;       ///< the callback ran longer than the execution budget
+  bool     late_start;    ///< the callback started later than the tolerance after the deadline
+  uint32_t execution_us;  ///< measured callback runtime
+  int64_t  lateness_us;   ///< measured start time minus deadline
+};
+
+/**
+ * @brief Function called from the task loop after each run that violates its timing limits
+ */
+using TimingHook = void (*)(TimingViolation const& violation);
+
+#if defined(MAMETASK_ENABLE_STATS)
+/**
+ * @brief Runtime statistics of a task
+ *
+ * Only available when MAMETASK_ENABLE_STATS is defined for every translation
+ * unit; otherwise the trampoline records nothing and tasks carry no counters.
+ */
+struct TaskStats
+{
+  uint32_t run_count          = 0;           ///< completed runs
+  uint32_t overrun_count      = 0;           ///< runs that ended after their next deadline
+  uint32_t min_execution_us   = UINT32_MAX;  ///< shortest callback runtime
+  uint32_t max_execution_us   = 0;           ///< longest callback runtime
+  uint64_t total_execution_us = 0;           ///< sum of callback runtimes
+  int64_t  max_lateness_us    = 0;           ///< largest start time minus deadline
+  int64_t  total_lateness_us  = 0;           ///< sum of start time minus deadline
+
+  /**
+   * @brief Gets the mean callback runtime
+   *
+   * @return The mean execution time in microseconds, or 0 before the first run
+   */
+  uint32_t mean_execution_us() const
+  {
+    return run_count ? static_cast<uint32_t>(total_execution_us / run_count) : 0;
+  }
+
+  /**
+   * @brief Gets the mean delay between a deadline and the start of its run
+   *
+   * @return The mean lateness in microseconds, or 0 before the first run
+   */
+  int64_t mean_lateness_us() const { return run_count ? total_lateness_us / run_count : 0; }
+
+  /**
+   * @brief Records one run of a task
+   *
+   * @param deadline The deadline the run was released for
+   * @param start The time the callback was entered
+   * @param end The time the callback returned
+   * @param period The task period
+   */
+  void record(absolute_time_t deadline, absolute_time_t start, absolute_time_t end, std::chrono::microseconds period)
+  {
+    uint32_t const execution_us = static_cast<uint32_t>(absolute_time_diff_us(start, end));
+    int64_t const  lateness_us  = absolute_time_diff_us(deadline, start);
+    run_count++;
+    min_execution_us = execution_us < min_execution_us ? execution_us : min_execution_us;
+    max_execution_us = execution_us > max_execution_us ? execution_us : max_execution_us;
+    total_execution_us += execution_us;
+    max_lateness_us = lateness_us > max_lateness_us ? lateness_us : max_lateness_us;
+    total_lateness_us += lateness_us;
+    if (absolute_time_diff_us(deadline, end) > period.count())
+    {
+      overrun_count++;
+    }
+  }
+};
+#endif
+
+/**
+ * @brief Computes the deadline of a periodic task following the one that has just been served
+ *
+ * @param deadline The deadline of the run that has just completed
+ * @param period_us The task period in microseconds
+ * @param policy How the next deadline is computed
+ * @return The absolute time at which the task is due next
+ */
+inline absolute_time_t next_deadline_after(absolute_time_t deadline, uint64_t period_us, SchedulePolicy policy)
+{
+  if (policy == SchedulePolicy::relative)
+  {
+    return make_timeout_time_us(period_us);
+  }
+
+  absolute_time_t next = delayed_by_us(deadline, period_us);
+  if (policy == SchedulePolicy::burst || period_us == 0)
+  {
+    return next;
+  }
+
+  int64_t const behind_us = absolute_time_diff_us(next, get_absolute_time());
+  if (behind_us > 0)
+  {
+    // Move to the latest deadline that has already passed, and past it when skipping
+    next = delayed_by_us(next, (behind_us / period_us) * period_us);
+    if (policy == SchedulePolicy::skip && absolute_time_diff_us(next, get_absolute_time()) > 0)
+    {
+      next = delayed_by_us(next, period_us);
+    }
+  }
+  return next;
+}
+
+/**
+ * @brief Arguments for constructing a ScheduledTask in place inside a TaskRunner
+ *
+ * Refers to the callback rather than holding it, so the callback is moved
+ * once, straight into the runner's storage. Create it with task_descriptor()
+ * in the expression that constructs the runner.
+ *
+ * @tparam F The type of the callable object
+ */
+template<TaskCallable F>
+struct ScheduledTaskDescriptor
+{
+  std::chrono::microseconds period;
+  F&&                       callback;
+  SchedulePolicy            policy;
+  uint8_t                   priority;
+};
+
+/**
+ * @brief Computes initial phase offsets that spread periodic tasks over separate ticks
+ *
+ * Two tasks with offsets a and b are due in the same tick exactly when
+ * a and b are congruent modulo the GCD of their periods. Tasks are placed
+ * shortest period first, each at the offset within its period that collides
+ * with the fewest tasks placed so far. Usable at compile time for static task
+ * sets; TaskRunner::stagger() runs it at startup.
+ *
+ * @param periods_us The task periods in microseconds; 0 marks a task to leave unshifted
+ * @param resolution_us The tick that offsets are multiples of
+ * @return The offset of each task in microseconds
+ */
+template<std::size_t N>
+constexpr std::array<uint64_t, N> stagger_offsets(std::array<uint64_t, N> const& periods_us, uint64_t resolution_us)
+{
+  std::array<uint64_t, N>    offsets{};
+  std::array<bool, N>        placed{};
+  std::array<std::size_t, N> order{};
+  for (std::size_t i = 0; i < N; i++)
+  {
+    // Insertion sort by period, stable so that ties keep the task order
+    std::size_t j = i;
+    for (; j > 0 && periods_us[order[j - 1]] > periods_us[i]; j--)
+    {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+  }
+
+  for (std::size_t index : order)
+  {
+    uint64_t const period = periods_us[index];
+    if (period < resolution_us || resolution_us == 0)
+    {
+      // Due every tick, so there is nothing to gain
+      continue;
+    }
+    uint64_t best_offset     = 0;
+    uint32_t best_collisions = UINT32_MAX;
+    for (uint64_t offset = 0; offset < period && best_collisions != 0; offset += resolution_us)
+    {
+      uint32_t collisions = 0;
+      for (std::size_t other = 0; other < N; other++)
+      {
+        if (placed[other])
+        {
+          uint64_t const common = std::gcd(period, periods_us[other]);
+          collisions += offset % common == offsets[other] % common;
+        }
+      }
+      if (collisions < best_collisions)
+      {
+        best_offset     = offset;
+        best_collisions = collisions;
+      }
+    }
+    offsets[index] = best_offset;
+    placed[index]  = true;
+  }
+  return offsets;
+}
+
+/**
+ * @brief Processor load of a TaskRunner, measured in fixed windows
+ *
+ * Utilizations are in parts per million of the window. The average is an
+ * exponentially weighted moving average over the completed windows.
+ */
+struct CpuLoad
+{
+  uint64_t busy_us     = 0;  ///< time spent in polls that ran a task
+  uint64_t idle_us     = 0;  ///< time spent between polls and in polls that found nothing to run
+  uint32_t last_ppm    = 0;  ///< utilization of the last completed window
+  uint32_t average_ppm = 0;  ///< moving average of the window utilizations
+  uint32_t peak_ppm    = 0;  ///< highest utilization of a single window
+  uint32_t windows     = 0;  ///< completed windows
+  uint32_t runs        = 0;  ///< task runs counted so far
+
+  /**
+   * @brief Gets the moving average utilization
+   *
+   * @return The fraction of time the runner was busy, from 0 to 1
+   */
+  float utilization() const { return static_cast<float>(average_ppm) / 1e6f; }
+
+  /**
+   * @brief Gets the utilization of the busiest window
+   *
+   * @return The fraction of that window the runner was busy, from 0 to 1
+   */
+  float peak_utilization() const { return static_cast<float>(peak_ppm) / 1e6f; }
+};
+
+/**
+ * @brief Splits time into busy and idle windows and keeps a CpuLoad up to date
+ *
+ * The first task run of a poll takes a timestamp and the end of that poll
+ * another, while polls without a run take none, so it stays enabled in every
+ * build. Time up to a busy interval is idle; windows are closed lazily when
+ * time is next accounted.
+ */
+class LoadMeter
+{
+private:
+  CpuLoad  load;
+  uint64_t cursor_us       = 0;  // time accounted so far
+  uint64_t window_end_us   = 0;
+  uint64_t run_start_us    = 0;  // start of the open busy interval
+  uint32_t window_us       = 100000;
+  uint32_t window_busy_us  = 0;
+  uint8_t  smoothing_shift = 3;
+  bool     running         = false;  // whether a busy interval is open
+
+  void close_window()
+  {
+    uint32_t const ppm  = static_cast<uint32_t>(uint64_t{ window_busy_us } * 1000000 / window_us);
+    int32_t const  step = static_cast<int32_t>(ppm) - static_cast<int32_t>(load.average_ppm);
+    // Round away from zero so that the average settles on the window value
+    int32_t const bias = (int32_t{ 1 } << smoothing_shift) - 1;
+    load.average_ppm += step >= 0 ? (step + bias) >> smoothing_shift : -((-step + bias) >> smoothing_shift);
+    load.last_ppm  = ppm;
+    load.peak_ppm  = ppm > load.peak_ppm ? ppm : load.peak_ppm;
+    load.windows++;
+    window_busy_us = 0;
+    window_end_us += window_us;
+  }
+
+  /**
+   * @brief Accounts the time from the cursor to now as busy or idle
+   */
+  void advance(uint64_t now_us, bool busy)
+  {
+    if (now_us < cursor_us)
+    {
+      // Already accounted, e.g. by a read of the figures during the poll
+      return;
+    }
+    while (now_us >= window_end_us)
+    {
+      if (!busy && window_busy_us == 0 && load.average_ppm == 0 && load.last_ppm == 0)
+      {
+        // Further idle windows change nothing but the count
+        uint64_t const skipped = (now_us - window_end_us) / window_us + 1;
+        load.windows += static_cast<uint32_t>(skipped);
+        window_end_us += skipped * window_us;
+        break;
+      }
+      uint64_t const span = window_end_us - cursor_us;
+      (busy ? load.busy_us : load.idle_us) += span;
+      window_busy_us += busy ? static_cast<uint32_t>(span) : 0;
+      cursor_us = window_end_us;
+      close_window();
+    }
+    uint64_t const span = now_us - cursor_us;
+    (busy ? load.busy_us : load.idle_us) += span;
+    window_busy_us += busy ? static_cast<uint32_t>(span) : 0;
+    cursor_us = now_us;
+  }
+
+public:
+  /**
+   * @brief Starts a new measurement at the given time
+   *
+   * @param now The start of the first window
+   */
+  void reset(absolute_time_t now)
+  {
+    load           = CpuLoad{};
+    cursor_us      = to_us_since_boot(now);
+    window_end_us  = cursor_us + window_us;
+    window_busy_us = 0;
+    run_start_us   = cursor_us;
+  }
+
+  /**
+   * @brief Sets the window length and the weight of each window in the average, then restarts the measurement
+   *
+   * @param window The length of a window
+   * @param shift Each window moves the average by 1 / 2^shift of the difference
+   * @param now The start of the first window
+   */
+  void configure(std::chrono::microseconds window, uint8_t shift, absolute_time_t now)
+  {
+    window_us       = window.count() > 0 ? static_cast<uint32_t>(window.count()) : 1;
+    smoothing_shift = shift < 8 ? shift : 8;
+    reset(now);
+  }
+
+  /**
+   * @brief Counts a task run; the first one since finish_runs() opens a busy interval
+   */
+  void run_started()
+  {
+    load.runs++;
+    if (!running)
+    {
+      running      = true;
+      run_start_us = to_us_since_boot(get_absolute_time());
+    }
+  }
+
+  /**
+   * @brief Counts runs that were detected after they took place
+   *
+   * @param start A time before the runs, which opens the busy interval
+   * @param runs The number of runs
+   */
+  void runs_since(absolute_time_t start, uint32_t runs)
+  {
+    uint64_t const start_us = to_us_since_boot(start);
+    load.runs += runs;
+    run_start_us = running && run_start_us < start_us ? run_start_us : start_us;
+    running      = true;
+  }
+
+  /**
+   * @brief Closes the busy interval opened by the runs of a poll, if any
+   */
+  void finish_runs()
+  {
+    if (running)
+    {
+      running = false;
+      advance(run_start_us, false);
+      advance(to_us_since_boot(get_absolute_time()), true);
+    }
+  }
+
+  /**
+   * @brief Accounts the time up to now, e.g. before the figures are read
+   *
+   * @param now The current time
+   */
+  void update(absolute_time_t now)
+  {
+    uint64_t const now_us = to_us_since_boot(now);
+    if (running)
+    {
+      advance(run_start_us, false);
+      advance(now_us, true);
+      run_start_us = now_us;
+    }
+    else
+    {
+      advance(now_us, false);
+    }
+  }
+
+  CpuLoad const& get_load() const { return load; }
+};
+
+/**
+ * @brief Base of the task types that report their runs to their runner's load meter
+ */
+class RunReporter
+{
+private:
+  LoadMeter* load_meter = nullptr;
+
+public:
+  /**
+   * @brief Sets the meter that is told about each run; called by TaskRunner
+   *
+   * @param meter The load meter of the runner
+   */
+  void set_load_meter(LoadMeter* meter) { load_meter = meter; }
+
+protected:
+  /**
+   * @brief Marks the current poll busy; called at the start of each run
+   */
+  void report_run() const
+  {
+    if (load_meter)
+    {
+      load_meter->run_started();
+    }
+  }
+};
+
 // Forward declarations for internal implementation details
 template<TaskCallable F>
 class ScheduledTask;
 
 /**
- * @brief Wrapper class for the async context to encapsulate PICO SDK dependencies
+ * @brief Wrapper class for the async context to encapsulate PICO SDK dependencies
+ *
+ * Manages a collection of scheduled tasks and provides methods to poll and run them
+ */
+template<RunnableTask... Tasks>
+class TaskRunner
+{
+private:
+  static_assert(sizeof...(Tasks) <= 32, "the ready mask holds at most 32 tasks");
+
+  static constexpr std::size_t no_task = SIZE_MAX;
+
+  async_context_poll_t poll_context;
+  async_context_t*     context;
+  std::tuple<Tasks...> tasks;
+  DispatchMode         mode        = DispatchMode::fifo;
+  uint32_t             ready_tasks = 0;
+  LoadMeter            load_meter;
+
+  /**
+   * @brief Keeps task I as the next to dispatch if it is ready and ahead of the current best
+   */
+  template<std::size_t I>
+  void select_if_ahead(std::size_t& best, uint64_t& best_key) const
+  {
+    using Task = std::tuple_element_t<I, std::tuple<Tasks...>>;
+    if constexpr (PrioritizedTask<Task>)
+    {
+      if (ready_tasks & (1u << I))
+      {
+        // Higher priority or earlier deadline first; the tuple order breaks ties
+        auto const&    task = std::get<I>(tasks);
+        uint64_t const key  = mode == DispatchMode::edf
+                              ? to_us_since_boot(task.get_absolute_deadline())
+                              : UINT8_MAX - static_cast<uint8_t>(task.get_priority());
+        if (best == no_task || key < best_key)
+        {
+          best     = I;
+          best_key = key;
+        }
+      }
+    }
+  }
+
+  template<std::size_t... I>
+  std::size_t select_ready(std::index_sequence<I...>) const
+  {
+    std::size_t best     = no_task;
+    uint64_t    best_key = 0;
+    (select_if_ahead<I>(best, best_key), ...);
+    return best;
+  }
+
+  template<std::size_t... I>
+  void run_ready(std::size_t index, std::index_sequence<I...>)
+  {
+    (
+      [&]
+      {
+        if constexpr (PrioritizedTask<std::tuple_element_t<I, std::tuple<Tasks...>>>)
+        {
+          if (index == I)
+          {
+            std::get<I>(tasks).run(context);
+          }
+        }
+      }(),
+      ...);
+  }
+
+  /**
+   * @brief Runs the deferred tasks one at a time in dispatch order
+   */
+  void dispatch_ready()
+  {
+    while (ready_tasks)
+    {
+      std::size_t const index = select_ready(std::index_sequence_for<Tasks...>{});
+      ready_tasks &= ~(1u << index);
+      run_ready(index, std::index_sequence_for<Tasks...>{});
+      // Let tasks that became due meanwhile compete with the remaining ones
+      async_context_poll(context);
+    }
+  }
+
+  /**
+   * @brief Gets the release time of task I, or 0 if it reports its runs or has none to watch
+   */
+  template<std::size_t I>
+  uint64_t get_release_us()
+  {
+    using Task = std::tuple_element_t<I, std::tuple<Tasks...>>;
+    if constexpr (!RunReportingTask<Task> && !AttachableTask<Task>)
+    {
+      return to_us_since_boot(std::get<I>(tasks).get_native_worker().next_time);
+    }
+    else
+    {
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Polls the context once, counting the runs of tasks that do not report them
+   *
+   * An at-time task has run when its worker's release time moved. Other tasks
+   * that do not report their runs may have run in any poll, so they count one
+   * run per poll.
+   */
+  template<std::size_t... I>
+  void poll_unreported(std::index_sequence<I...>)
+  {
+    absolute_time_t const start      = get_absolute_time();
+    uint64_t const        releases[] = { get_release_us<I>()... };
+    async_context_poll(context);
+    dispatch_ready();
+    uint32_t const runs = (uint32_t{ 0 } + ... +
+                           [&]
+                           {
+                             using Task = std::tuple_element_t<I, std::tuple<Tasks...>>;
+                             if constexpr (RunReportingTask<Task>)
+                             {
+                               return uint32_t{ 0 };
+                             }
+                             else if constexpr (AttachableTask<Task>)
+                             {
+                               return uint32_t{ 1 };
+                             }
+                             else
+                             {
+                               return uint32_t{ get_release_us<I>() != releases[I] };
+                             }
+                           }());
+    if (runs)
+    {
+      load_meter.runs_since(start, runs);
+    }
+  }
+
+  /**
+   * @brief Adds a task to the context; periodic tasks run as soon as the context is polled
+   */
+  template<typename Task>
+  void attach(Task& task)
+  {
+    if constexpr (RunReportingTask<Task>)
+    {
+      task.set_load_meter(&load_meter);
+    }
+    if constexpr (AttachableTask<Task>)
+    {
+      task.attach(*context);
+    }
+    else
+    {
+      async_context_add_at_time_worker_in_ms(context, &task.get_native_worker(), 0);
+    }
+  }
+
+  /**
+   * @brief Adds every task to the context once they have reached their final storage
+   */
+  void schedule_tasks()
+  {
+    std::apply([this](auto&... task) { (attach(task), ...); }, tasks);
+  }
+
+  /**
+   * @brief Removes a task's workers from the context
+   */
+  template<typename Task>
+  void detach(Task& task)
+  {
+    if constexpr (DetachableTask<Task>)
+    {
+      task.detach(*context);
+    }
+    else if constexpr (!AttachableTask<Task>)
+    {
+      async_context_remove_at_time_worker(context, &task.get_native_worker());
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs a TaskRunner with the given tasks
+   *
+   * Each task is constructed in the runner's storage from its argument, which
+   * is either a task to move in or a descriptor such as the one returned by
+   * task_descriptor(). Tasks are added to the async context only once they are
+   * in place.
+   *
+   * @param args The scheduled tasks to run, or descriptors of them
+   */
+  template<typename... Args>
+    requires(sizeof...(Args) == sizeof...(Tasks) && (std::constructible_from<Tasks, Args &&> && ...))
+  TaskRunner(Args&&... args)
+    : context(&poll_context.core)
+    , tasks(std::forward<Args>(args)...)
+  {
+    async_context_poll_init_with_defaults(&poll_context);
+    schedule_tasks();
+    load_meter.reset(get_absolute_time());
+  }
+
+  /**
+   * @brief Constructs a TaskRunner that schedules its tasks on an existing async context
+   *
+   * Allows alternative scheduler backends such as TimingWheelContext, or an SDK
+   * context shared with other libraries. The context must outlive the runner,
+   * which takes its tasks off the context again when it is destroyed.
+   *
+   * @param async_context The initialized async context to schedule the tasks on
+   * @param args The scheduled tasks to run, or descriptors of them
+   */
+  template<typename... Args>
+    requires(sizeof...(Args) == sizeof...(Tasks) && (std::constructible_from<Tasks, Args &&> && ...))
+  TaskRunner(async_context_t& async_context, Args&&... args)
+    : context(&async_context)
+    , tasks(std::forward<Args>(args)...)
+  {
+    schedule_tasks();
+    load_meter.reset(get_absolute_time());
+  }
+
+  /**
+   * @brief Removes the tasks from an external context, which would otherwise keep running them
+   */
+  ~TaskRunner()
+  {
+    if (context != &poll_context.core)
+    {
+      std::apply([this](auto&... task) { (detach(task), ...); }, tasks);
+    }
+  }
+
+  // Prevent copying to avoid resource management issues
+  TaskRunner(const TaskRunner&)            = delete;
+  TaskRunner& operator=(const TaskRunner&) = delete;
+
+  /**
+   * @brief Polls the async context once to execute any ready tasks
+   */
+  void poll()
+  {
+    if constexpr ((RunReportingTask<Tasks> && ...))
+    {
+      async_context_poll(context);
+      dispatch_ready();
+    }
+    else
+    {
+      poll_unreported(std::index_sequence_for<Tasks...>{});
+    }
+    load_meter.finish_runs();
+  }
+
+  /**
+   * @brief Selects the order in which tasks that are due together are dispatched
+   *
+   * In DispatchMode::priority and DispatchMode::edf, tasks that provide a
+   * priority and a deadline (such as ScheduledTask) only mark themselves ready
+   * inside the async context poll and are then run by poll() highest priority
+   * or earliest absolute deadline first. Dispatch stays
+   * cooperative: a running task is never interrupted, but after each run
+   * newly due tasks are collected before the next one is chosen. Other task
+   * types keep running directly from the async context.
+   *
+   * @param new_mode The dispatch mode
+   */
+  void set_dispatch_mode(DispatchMode new_mode)
+  {
+    dispatch_ready();
+    mode = new_mode;
+    [this]<std::size_t... I>(std::index_sequence<I...>)
+    {
+      (
+        [this]
+        {
+          if constexpr (PrioritizedTask<std::tuple_element_t<I, std::tuple<Tasks...>>>)
+          {
+            std::get<I>(tasks).defer_to(mode == DispatchMode::fifo ? nullptr : &ready_tasks, 1u << I, mode == DispatchMode::edf);
+          }
+        }(),
+        ...);
+    }(std::index_sequence_for<Tasks...>{});
+  }
+
+  /**
+   * @brief Shifts the first release of each periodic task so that as few tasks as possible are due together
+   *
+   * Call before the first poll. Offsets come from stagger_offsets() and are
+   * counted from now; paused tasks and tasks without a period are left alone.
+   * Without staggering every task is first due on the first poll, so tasks
+   * with harmonic periods keep coinciding.
+   *
+   * @param resolution The tick that offsets are multiples of, e.g. std::chrono::milliseconds{ 1 }
+   */
+  void stagger(std::chrono::microseconds resolution = std::chrono::milliseconds{ 1 })
+  {
+    [this, resolution]<std::size_t... I>(std::index_sequence<I...>)
+    {
+      std::array<uint64_t, sizeof...(Tasks)> periods_us{};
+      (
+        [&]
+        {
+          if constexpr (PeriodicTask<std::tuple_element_t<I, std::tuple<Tasks...>>>)
+          {
+            periods_us[I] = static_cast<uint64_t>(std::get<I>(tasks).get_period().count());
+          }
+        }(),
+        ...);
+      auto const offsets_us = stagger_offsets(periods_us, static_cast<uint64_t>(resolution.count()));
+
+      absolute_time_t const start = get_absolute_time();
+      (
+        [&]
+        {
+          if constexpr (PeriodicTask<std::tuple_element_t<I, std::tuple<Tasks...>>>)
+          {
+            async_at_time_worker_t& worker = std::get<I>(tasks).get_native_worker();
+            if (async_context_remove_at_time_worker(context, &worker))
+            {
+              async_context_add_at_time_worker_at(context, &worker, delayed_by_us(start, offsets_us[I]));
+            }
+          }
+        }(),
+        ...);
+    }(std::index_sequence_for<Tasks...>{});
+  }
+
+  /**
+   * @brief Counts deadline misses of all tasks that support it, in every dispatch mode
+   *
+   * @param enabled Whether to count deadline misses; DispatchMode::edf counts them regardless
+   */
+  void set_deadline_tracking(bool enabled)
+  {
+    std::apply(
+      [enabled](auto&... task)
+      {
+        (
+          [&]
+          {
+            if constexpr (requires { task.set_deadline_tracking(enabled); })
+            {
+              task.set_deadline_tracking(enabled);
+            }
+          }(),
+          ...);
+      },
+      tasks);
+  }
+
+  /**
+   * @brief Sets the function called after each run that exceeds its task's execution budget or start tolerance
+   *
+   * The hook receives the index of the task in this runner. Budgets and
+   * tolerances are set per task, e.g. with ScheduledTask::set_execution_budget().
+   *
+   * @param hook The function to call, or nullptr to stop checking
+   */
+  void set_timing_hook(TimingHook hook)
+  {
+    [this, hook]<std::size_t... I>(std::index_sequence<I...>)
+    {
+      (
+        [&]
+        {
+          if constexpr (requires { std::get<I>(tasks).set_timing_hook(hook, uint8_t{}); })
+          {
+            std::get<I>(tasks).set_timing_hook(hook, static_cast<uint8_t>(I));
+          }
+        }(),
+        ...);
+    }(std::index_sequence_for<Tasks...>{});
+  }
+
+  /**
+   * @brief Gets the current dispatch mode
+   */
+  DispatchMode get_dispatch_mode() const { return mode; }
+
+  /**
+   * @brief Gets the earliest pending task deadline
+   *
+   * @return The absolute time at which the next task is due
+   */
+  absolute_time_t get_next_deadline() const { return context->next_time; }
+
+  /**
+   * @brief Gets the async context the tasks are scheduled on
+   *
+   * @return Reference to the underlying async context
+   */
+  async_context_t& get_native_context() { return *context; }
+
+  /**
+   * @brief Sleeps until the next task is due, work is signalled, or the timeout expires
+   *
+   * @param until Absolute time after which to return even if nothing is due
+   */
+  void wait_for_work_until(absolute_time_t until) { async_context_wait_for_work_until(context, until); }
+
+  /**
+   * @brief Gets a task owned by the runner, e.g. to signal an EventTask
+   *
+   * @tparam I Index of the task in the order it was passed to the constructor
+   * @return Reference to the task
+   */
+  template<std::size_t I>
+  auto& get_task()
+  {
+    return std::get<I>(tasks);
+  }
+
+  /**
+   * @brief Gets the processor load measured so far
+   *
+   * Time inside a poll that ran one of the runner's tasks counts as busy, and
+   * time between polls or in polls that found nothing to run as idle, so the
+   * figures cover run_forever() as well as loops that spin on poll(). Tasks
+   * that do not report their runs (see RunReportingTask) are watched through
+   * their worker's release time, or if they have none, make every poll busy.
+   * The figures are brought up to date first.
+   *
+   * @return The busy and idle totals and the window utilizations
+   */
+  CpuLoad const& get_cpu_load()
+  {
+    load_meter.update(get_absolute_time());
+    return load_meter.get_load();
+  }
+
+  /**
+   * @brief Sets the window over which utilization is measured and restarts the measurement
+   *
+   * @param window The length of a window; 100ms by default
+   * @param smoothing_shift Each window moves the average by 1 / 2^smoothing_shift of the difference; at most 8
+   */
+  void set_load_window(std::chrono::microseconds window, uint8_t smoothing_shift = 3)
+  {
+    load_meter.configure(window, smoothing_shift, get_absolute_time());
+  }
+
+  /**
+   * @brief Clears the load figures, e.g. after startup, and starts a new window
+   */
+  void reset_cpu_load() { load_meter.reset(get_absolute_time()); }
+
+  /**
+   * @brief Runs work from outside the async context as part of this runner's load, e.g. a stolen job
+   *
+   * The work reports its runs to the meter it is passed, which then counts
+   * them and their time as busy like the runs of a poll.
+   *
+   * @param work Called with the runner's LoadMeter; returns whether it did any work
+   * @return What work returned
+   */
+  template<typename Work>
+  bool run_metered(Work&& work)
+  {
+    bool const ran = work(load_meter);
+    load_meter.finish_runs();
+    return ran;
+  }
+
+#if defined(MAMETASK_ENABLE_STATS)
+  /**
+   * @brief Gets the runtime statistics of a task
+   *
+   * @tparam I Index of the task in the order it was passed to the constructor
+   * @return The statistics collected so far
+   */
+  template<std::size_t I>
+  TaskStats const& get_task_stats() const
+  {
+    return std::get<I>(tasks).get_stats();
+  }
+#endif
+
+  /**
+   * @brief Runs the task loop indefinitely without a fixed tick
+   *
+   * Sleeps exactly until the earliest pending deadline after each poll, so
+   * tasks are dispatched as soon as they are due and the core stays idle
+   * while nothing is scheduled. Earlier versions polled every 10ms here;
+   * call run_forever(10) for that loop.
+   */
+  void run_forever()
+  {
+    while (true)
+    {
+      poll();
+      wait_for_work_until(at_the_end_of_time);
+    }
+  }
+
+  /**
+   * @brief Runs the task loop indefinitely, polling at regular intervals
+   *
+   * @param poll_interval_ms Time between polls in milliseconds
+   */
+  void run_forever(uint32_t poll_interval_ms)
+  {
+    while (true)
+    {
+      poll();
+      sleep_ms(poll_interval_ms);
+    }
+  }
+};
+
+/**
+ * @brief Wrapper class for a scheduled task to encapsulate PICO SDK dependencies
+ *
+ * @tparam F The type of the callable object
+ */
+template<TaskCallable F>
+class ScheduledTask : public RunReporter
+{
+private:
+  async_at_time_worker_t    worker;
+  F                         callback;
+  std::chrono::microseconds period;
+  SchedulePolicy const      policy;
+  uint8_t const             priority;
+  std::chrono::microseconds relative_deadline;
+  uint32_t                  deadline_misses = 0;
+  // Deadline misses are counted on request and always in DispatchMode::edf
+  bool track_deadlines = false;
+  bool edf_dispatch    = false;
+  // Set by the runner when it orders dispatch itself
+  uint32_t* ready_tasks = nullptr;
+  uint32_t  ready_bit   = 0;
+  // Timing limits; a zero budget and the maximum tolerance disable the checks
+  TimingHook timing_hook         = nullptr;
+  uint32_t   execution_budget_us = 0;
+  uint32_t   start_tolerance_us  = UINT32_MAX;
+  uint8_t    task_id             = 0;
+  // Lifecycle state; runs_left == 0 means no limit
+  async_context_t* context     = nullptr;
+  uint32_t         runs_left   = 0;
+  bool             paused      = false;
+  bool             in_callback = false;
+  bool             rescheduled = false;
+#if defined(MAMETASK_ENABLE_STATS)
+  TaskStats stats;
+#endif
+
+  /**
+   * @brief Computes the deadline following the one that has just been served
+   *
+   * @param deadline The deadline of the run that has just completed
+   * @return The absolute time at which the task is due next
+   */
+  absolute_time_t next_deadline(absolute_time_t deadline) const
+  {
+    return next_deadline_after(deadline, period.count(), policy);
+  }
+
+  /**
+   * @brief Reports a run to the timing hook if it exceeded the budget or started too late
+   */
+  void check_timing(absolute_time_t release, absolute_time_t start, absolute_time_t end) const
+  {
+    TimingViolation violation{ .task_id      = task_id,
+                               .overrun      = false,
+                               .late_start   = false,
+                               .execution_us = static_cast<uint32_t>(absolute_time_diff_us(start, end)),
+                               .lateness_us  = absolute_time_diff_us(release, start) };
+    violation.overrun    = execution_budget_us != 0 && violation.execution_us > execution_budget_us;
+    violation.late_start = violation.lateness_us > static_cast<int64_t>(start_tolerance_us);
+    if (violation.overrun || violation.late_start)
+    {
+      timing_hook(violation);
+    }
+  }
+
+  /**
+   * @brief Moves the next release to the given time, wherever the task currently is
+   */
+  void reschedule_at(absolute_time_t time)
+  {
+    if (!context)
+    {
+      // attach() picks the time up
+      worker.next_time = time;
+      return;
+    }
+    withdraw();
+    async_context_add_at_time_worker_at(context, &worker, time);
+    rescheduled = in_callback;
+  }
+
+  /**
+   * @brief Takes the pending release out of the async context and the runner's ready mask
+   */
+  void withdraw()
+  {
+    async_context_remove_at_time_worker(context, &worker);
+    if (ready_tasks)
+    {
+      *ready_tasks &= ~ready_bit;
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs a ScheduledTask with the given interval and callback
+   *
+   * @param interval The interval in milliseconds at which to run the task
+   * @param callback The function to call when the task is executed
+   * @param policy How the next deadline is computed after each run
+   * @param priority Dispatch priority in DispatchMode::priority; higher runs first
+   */
+  ScheduledTask(unsigned       interval,
+                F&&            callback,
+                SchedulePolicy policy   = SchedulePolicy::relative,
+                uint8_t        priority = 0)
+    : ScheduledTask(std::chrono::milliseconds{ interval }, std::forward<F>(callback), policy, priority)
+  {
+  }
+
+  /**
+   * @brief Constructs a ScheduledTask with the given period and callback
+   *
+   * @param period The period at which to run the task, with microsecond resolution
+   * @param callback The function to call when the task is executed
+   * @param policy How the next deadline is computed after each run
+   * @param priority Dispatch priority in DispatchMode::priority; higher runs first
+   */
+  template<typename Rep, typename Period>
+  ScheduledTask(std::chrono::duration<Rep, Period> period,
+                F&&                                callback,
+                SchedulePolicy                     policy   = SchedulePolicy::relative,
+                uint8_t                            priority = 0)
+    : callback(std::forward<F>(callback))
+    , period(std::chrono::duration_cast<std::chrono::microseconds>(period))
+    , policy(policy)
+    , priority(priority)
+    , relative_deadline(this->period)
+  {
+    // Create worker
+    worker = { .do_work =
+                 [](async_context_t* context, async_at_time_worker_t* worker)
+               {
+                 auto* self = reinterpret_cast<ScheduledTask*>(worker->user_data);
+                 if (self->ready_tasks)
+                 {
+                   // The runner dispatches it after the poll
+                   *self->ready_tasks |= self->ready_bit;
+                   return;
+                 }
+                 self->run(context);
+               },
+               .user_data = reinterpret_cast<void*>(this) };
+  }
+
+  /**
+   * @brief Constructs a ScheduledTask from a descriptor, in place
+   *
+   * @param descriptor The period, callback, policy and priority of the task
+   */
+  ScheduledTask(ScheduledTaskDescriptor<F>&& descriptor)
+    : ScheduledTask(descriptor.period, std::forward<F>(descriptor.callback), descriptor.policy, descriptor.priority)
+  {
+  }
+
+  /**
+   * @brief Runs the callback for the current release and reschedules the task
+   *
+   * Called from the worker, or by the runner for deferred dispatch.
+   *
+   * @param context The async context the task is scheduled on
+   */
+  void run(async_context_t* context)
+  {
+    if (paused)
+    {
+      // Paused after the worker marked it ready
+      return;
+    }
+    report_run();
+    bool const            last_run = runs_left != 0 && --runs_left == 0;
+    absolute_time_t const release  = worker.next_time;
+
+    bool const counts_misses = track_deadlines || edf_dispatch;
+#if defined(MAMETASK_ENABLE_STATS)
+    bool const timed = true;
+#else
+    // Without a consumer for the timestamps the dispatch stays as cheap as a bare callback
+    bool const timed = counts_misses || timing_hook;
+#endif
+    in_callback = true;
+    if (!timed)
+    {
+      callback();
+      in_callback = false;
+    }
+    else
+    {
+      absolute_time_t const start = get_absolute_time();
+      callback();
+      absolute_time_t const end = get_absolute_time();
+      in_callback = false;
+#if defined(MAMETASK_ENABLE_STATS)
+      stats.record(release, start, end, period);
+#endif
+
+      if (counts_misses && absolute_time_diff_us(delayed_by_us(release, relative_deadline.count()), end) > 0)
+      {
+        deadline_misses++;
+      }
+      if (timing_hook)
+      {
+        check_timing(release, start, end);
+      }
+    }
+    if (rescheduled)
+    {
+      // The callback already chose the next release
+      rescheduled = false;
+      return;
+    }
+    if (paused || (last_run && runs_left == 0))
+    {
+      paused = true;
+      return;
+    }
+    async_context_add_at_time_worker_at(context, &worker, next_deadline(release));
+  }
+
+  /**
+   * @brief Adds the task to an async context; called by TaskRunner
+   *
+   * The first run is due on the next poll, unless the task is paused or a
+   * start time was set with run_once_after().
+   *
+   * @param async_context The context whose poll runs the task
+   */
+  void attach(async_context_t& async_context)
+  {
+    context = &async_context;
+    if (paused)
+    {
+      return;
+    }
+    if (to_us_since_boot(worker.next_time) == 0)
+    {
+      async_context_add_at_time_worker_in_ms(context, &worker, 0);
+    }
+    else
+    {
+      async_context_add_at_time_worker_at(context, &worker, worker.next_time);
+    }
+  }
+
+  /**
+   * @brief Removes the task from an async context; called by TaskRunner
+   *
+   * @param async_context The context the task was attached to
+   */
+  void detach(async_context_t& async_context)
+  {
+    async_context_remove_at_time_worker(&async_context, &worker);
+    context = nullptr;
+  }
+
+  /**
+   * @brief Stops running the task until resume() is called
+   *
+   * Removes the worker from the async context, so a paused task causes no
+   * wakeups. Safe to call from any task callback, including its own.
+   */
+  void pause()
+  {
+    paused = true;
+    if (context && !in_callback)
+    {
+      withdraw();
+    }
+  }
+
+  /**
+   * @brief Restarts a paused or finished task; its next run is due on the next poll
+   *
+   * Any limit set with run_n_times() still applies to a paused task; a task
+   * that has completed its runs resumes without a limit.
+   */
+  void resume()
+  {
+    if (!paused)
+    {
+      return;
+    }
+    paused = false;
+    if (!in_callback)
+    {
+      reschedule_at(get_absolute_time());
+    }
+  }
+
+  /**
+   * @brief Checks whether the task is paused, or has completed a limited number of runs
+   */
+  bool is_paused() const { return paused; }
+
+  /**
+   * @brief Runs the task once, the given number of milliseconds from now, and then stops
+   *
+   * @param ms Delay before the run in milliseconds
+   */
+  void run_once_after(unsigned ms)
+  {
+    runs_left = 1;
+    paused    = false;
+    reschedule_at(make_timeout_time_ms(ms));
+  }
+
+  /**
+   * @brief Limits the task to n more runs on its current schedule, then stops it
+   *
+   * A paused task is resumed. run_n_times(0) pauses the task.
+   *
+   * @param n The number of runs
+   */
+  void run_n_times(uint32_t n)
+  {
+    if (n == 0)
+    {
+      pause();
+      return;
+    }
+    runs_left = n;
+    resume();
+  }
+
+  /**
+   * @brief Gets the number of runs left before the task stops
+   *
+   * @return The remaining runs, or 0 if the task runs without a limit
+   */
+  uint32_t get_remaining_runs() const { return runs_left; }
+
+  /**
+   * @brief Sets the period of the task
+   *
+   * Takes effect when the next deadline is computed, i.e. after the pending
+   * run. A relative deadline that was equal to the period follows it.
+   *
+   * @param new_period The period, with microsecond resolution
+   */
+  template<typename Rep, typename Period>
+  void set_period(std::chrono::duration<Rep, Period> new_period)
+  {
+    if (relative_deadline == period)
+    {
+      relative_deadline = std::chrono::duration_cast<std::chrono::microseconds>(new_period);
+    }
+    period = std::chrono::duration_cast<std::chrono::microseconds>(new_period);
+  }
+
+  /**
+   * @brief Sets the interval of the task
+   *
+   * @param interval The interval in milliseconds
+   */
+  void set_interval(unsigned interval) { set_period(std::chrono::milliseconds{ interval }); }
+
+  /**
+   * @brief Makes the worker mark the task ready instead of running it; called by TaskRunner
+   *
+   * @param ready The runner's ready mask, or nullptr to run directly from the worker
+   * @param bit The bit identifying this task in the mask
+   * @param edf Whether the runner dispatches by deadline, which counts deadline misses
+   */
+  void defer_to(uint32_t* ready, uint32_t bit, bool edf = false)
+  {
+    ready_tasks  = ready;
+    ready_bit    = bit;
+    edf_dispatch = edf;
+  }
+
+  /**
+   * @brief Gets the dispatch priority of the task
+   *
+   * @return The priority; higher runs first in DispatchMode::priority
+   */
+  uint8_t get_priority() const { return priority; }
+
+  /**
+   * @brief Sets how long after its release each run must complete
+   *
+   * Defaults to the period. Used to order dispatch in DispatchMode::edf and to
+   * count deadline misses.
+   *
+   * @param deadline The relative deadline, with microsecond resolution
+   */
+  template<typename Rep, typename Period>
+  void set_relative_deadline(std::chrono::duration<Rep, Period> deadline)
+  {
+    relative_deadline = std::chrono::duration_cast<std::chrono::microseconds>(deadline);
+  }
+
+  /**
+   * @brief Gets the relative deadline of the task
+   *
+   * @return The relative deadline in microseconds
+   */
+  std::chrono::microseconds get_relative_deadline() const { return relative_deadline; }
+
+  /**
+   * @brief Gets the absolute deadline of the current or upcoming release
+   *
+   * @return The release time plus the relative deadline
+   */
+  absolute_time_t get_absolute_deadline() const
+  {
+    return delayed_by_us(worker.next_time, relative_deadline.count());
+  }
+
+  /**
+   * @brief Sets the function called after each run that violates the task's timing limits
+   *
+   * TaskRunner::set_timing_hook() sets it on all of its tasks.
+   *
+   * @param hook The function to call, or nullptr to stop checking
+   * @param id The task id reported to the hook
+   */
+  void set_timing_hook(TimingHook hook, uint8_t id)
+  {
+    timing_hook = hook;
+    task_id     = id;
+  }
+
+  /**
+   * @brief Sets the longest callback runtime that is not reported as an overrun
+   *
+   * @param budget The execution budget, with microsecond resolution; zero disables the check
+   */
+  template<typename Rep, typename Period>
+  void set_execution_budget(std::chrono::duration<Rep, Period> budget)
+  {
+    execution_budget_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(budget).count());
+  }
+
+  /**
+   * @brief Sets how long after its deadline a run may start before it is reported as late
+   *
+   * @param tolerance The start tolerance, with microsecond resolution
+   */
+  template<typename Rep, typename Period>
+  void set_start_tolerance(std::chrono::duration<Rep, Period> tolerance)
+  {
+    start_tolerance_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(tolerance).count());
+  }
+
+  /**
+   * @brief Counts the runs that complete after their absolute deadline
+   *
+   * Counting needs a timestamp after every run, so it is off by default
+   * outside DispatchMode::edf, which always counts.
+   *
+   * @param enabled Whether to count deadline misses
+   */
+  void set_deadline_tracking(bool enabled) { track_deadlines = enabled; }
+
+  /**
+   * @brief Gets the number of runs that completed after their absolute deadline
+   *
+   * Only runs made with deadline tracking or in DispatchMode::edf are counted.
+   */
+  uint32_t get_deadline_misses() const { return deadline_misses; }
+
+  /**
+   * @brief Gets the current interval for the task
+   *
+   * @return The current interval in milliseconds
+   */
+  unsigned get_interval() const
+  {
+    return static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(period).count());
+  }
+
+  /**
+   * @brief Gets the current period for the task
+   *
+   * @return The current period in microseconds
+   */
+  std::chrono::microseconds get_period() const { return period; }
+
+  /**
+   * @brief Gets the policy used to compute the next deadline
+   *
+   * @return The schedule policy of the task
+   */
+  SchedulePolicy get_policy() const { return policy; }
+
+  /**
+   * @brief Gets the callback stored in the task, e.g. to inspect a stateful functor
+   *
+   * @return Reference to the callable object
+   */
+  auto& get_callback() { return callback; }
+
+#if defined(MAMETASK_ENABLE_STATS)
+  /**
+   * @brief Gets the runtime statistics of the task
+   *
+   * @return The statistics collected so far
+   */
+  TaskStats const& get_stats() const { return stats; }
+
+  /**
+   * @brief Clears the runtime statistics of the task
+   */
+  void reset_stats() { stats = {}; }
+#endif
+
+  /**
+   * @brief Move constructor
+   *
+   * Points the worker at the new object so that the trampoline updates the
+   * instance owned by the runner rather than the moved-from one.
+   */
+  ScheduledTask(ScheduledTask&& other)
+    : RunReporter(other)
+    , worker(other.worker)
+    , callback(std::forward<F>(other.callback))
+    , period(other.period)
+    , policy(other.policy)
+    , priority(other.priority)
+    , relative_deadline(other.relative_deadline)
+    , deadline_misses(other.deadline_misses)
+    , track_deadlines(other.track_deadlines)
+    , edf_dispatch(other.edf_dispatch)
+    , ready_tasks(other.ready_tasks)
+    , ready_bit(other.ready_bit)
+    , timing_hook(other.timing_hook)
+    , execution_budget_us(other.execution_budget_us)
+    , start_tolerance_us(other.start_tolerance_us)
+    , task_id(other.task_id)
+    , context(other.context)
+    , runs_left(other.runs_left)
+    , paused(other.paused)
+#if defined(MAMETASK_ENABLE_STATS)
+    , stats(other.stats)
+#endif
+  {
+    worker.user_data = reinterpret_cast<void*>(this);
+  }
+  ScheduledTask& operator=(ScheduledTask&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  ScheduledTask(const ScheduledTask&)            = delete;
+  ScheduledTask& operator=(const ScheduledTask&) = delete;
+
+  /**
+   * @brief Gets the native worker for this task
+   *
+   * @return Reference to the async_at_time_worker_t
+   */
+  auto& get_native_worker() { return worker; }
+};
+
+/**
+ * @brief Periodic task whose period and schedule policy are part of its type
  *
- * Manages a collection of scheduled tasks and provides methods to poll and run them
+ * Stores only the worker and the callback, and the trampoline reschedules
+ * with a constant period. It has no priority, relative deadline or miss
+ * counter, so it always runs directly from the async context, as in
+ * DispatchMode::fifo. Use ScheduledTask when those are needed. The runner's
+ * load meter sees its runs from the worker's release time moving on.
+ *
+ * @tparam PeriodUs The period in microseconds
+ * @tparam F The type of the callable object
+ * @tparam Policy How the next deadline is computed after each run
  */
-template<ScheduledTaskInterface... Tasks>
-class TaskRunner
+template<uint64_t PeriodUs, TaskCallable F, SchedulePolicy Policy = SchedulePolicy::relative>
+class FixedPeriodTask
 {
 private:
-  async_context_poll_t context;
-  std::tuple<Tasks...> tasks;
+  async_at_time_worker_t worker;
+  F                      callback;
+#if defined(MAMETASK_ENABLE_STATS)
+  TaskStats stats;
+#endif
+
+  static void do_work(async_context_t* context, async_at_time_worker_t* worker)
+  {
+    reinterpret_cast<FixedPeriodTask*>(worker->user_data)->invoke(worker->next_time);
+    async_context_add_at_time_worker_at(context, worker, next_deadline_after(worker->next_time, PeriodUs, Policy));
+  }
 
 public:
+  static constexpr std::chrono::microseconds period{ PeriodUs };
+
   /**
-   * @brief Constructs a TaskRunner with the given tasks
+   * @brief Constructs a FixedPeriodTask with the given callback
    *
-   * @param args The scheduled tasks to run
+   * @param callback The function to call when the task is executed
    */
-  TaskRunner(Tasks&&... args)
-    : tasks(std::make_tuple(std::forward<Tasks>(args)...))
+  explicit FixedPeriodTask(F&& callback)
+    : worker{ .do_work = do_work, .user_data = reinterpret_cast<void*>(this) }
+    , callback(std::forward<F>(callback))
   {
-    async_context_poll_init_with_defaults(&context);
-
-    std::apply(
-      [this](auto&... task)
-      { (async_context_add_at_time_worker_in_ms(&context.core, &task.get_native_worker(), 0), ...); },
-      tasks
-    );
   }
 
-  ~TaskRunner() = default;
+  /**
+   * @brief Move constructor; points the worker at the new object
+   */
+  FixedPeriodTask(FixedPeriodTask&& other)
+    : worker(other.worker)
+    , callback(std::forward<F>(other.callback))
+#if defined(MAMETASK_ENABLE_STATS)
+    , stats(other.stats)
+#endif
+  {
+    worker.user_data = reinterpret_cast<void*>(this);
+  }
+  FixedPeriodTask& operator=(FixedPeriodTask&&) = delete;
 
   // Prevent copying to avoid resource management issues
-  TaskRunner(const TaskRunner&)            = delete;
-  TaskRunner& operator=(const TaskRunner&) = delete;
+  FixedPeriodTask(const FixedPeriodTask&)            = delete;
+  FixedPeriodTask& operator=(const FixedPeriodTask&) = delete;
 
   /**
-   * @brief Polls the async context once to execute any ready tasks
+   * @brief Runs the callback once without rescheduling
+   *
+   * Called from the worker, or by dispatchers that keep their own schedule
+   * such as CyclicExecutive.
+   *
+   * @param release The time the run was due, for the statistics
    */
-  void poll() { async_context_poll(&context.core); }
+  void invoke([[maybe_unused]] absolute_time_t release)
+  {
+#if defined(MAMETASK_ENABLE_STATS)
+    absolute_time_t const start = get_absolute_time();
+    callback();
+    stats.record(release, start, get_absolute_time(), period);
+#else
+    callback();
+#endif
+  }
 
   /**
-   * @brief Runs the task loop indefinitely, polling at regular intervals
+   * @brief Gets the interval for the task
    *
-   * @param poll_interval_ms Time between polls in milliseconds (default: 10ms)
+   * @return The interval in milliseconds
    */
-  void run_forever(uint32_t poll_interval_ms = 10)
+  static constexpr unsigned get_interval()
   {
-    while (true)
-    {
-      poll();
-      sleep_ms(poll_interval_ms);
-    }
+    return static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(period).count());
   }
+
+  /**
+   * @brief Gets the period for the task
+   *
+   * @return The period in microseconds
+   */
+  static constexpr std::chrono::microseconds get_period() { return period; }
+
+  /**
+   * @brief Gets the policy used to compute the next deadline
+   *
+   * @return The schedule policy of the task
+   */
+  static constexpr SchedulePolicy get_policy() { return Policy; }
+
+  /**
+   * @brief Gets the callback stored in the task, e.g. to inspect a stateful functor
+   *
+   * @return Reference to the callable object
+   */
+  auto& get_callback() { return callback; }
+
+#if defined(MAMETASK_ENABLE_STATS)
+  /**
+   * @brief Gets the runtime statistics of the task
+   *
+   * @return The statistics collected so far
+   */
+  TaskStats const& get_stats() const { return stats; }
+
+  /**
+   * @brief Clears the runtime statistics of the task
+   */
+  void reset_stats() { stats = {}; }
+#endif
+
+  /**
+   * @brief Gets the native worker for this task
+   *
+   * @return Reference to the async_at_time_worker_t
+   */
+  auto& get_native_worker() { return worker; }
 };
 
 /**
- * @brief Wrapper class for a scheduled task to encapsulate PICO SDK dependencies
+ * @brief Base of the tasks that run from an SDK when-pending worker after a signal
  *
- * @tparam F The type of the callable object
+ * Holds the worker and the context it is attached to, and calls
+ * Derived::run_pending() on the poll after signal(). Derived types report
+ * their runs themselves and befriend this base. A signal that arrives before
+ * the task is attached is kept, also across a move, and runs it on the first
+ * poll after attaching.
+ *
+ * @tparam Derived The task type
  */
-template<TaskCallable F>
-class ScheduledTask
+template<typename Derived>
+class PendingWorkerTask : public RunReporter
 {
 private:
-  async_at_time_worker_t worker;
-  F                      callback;
-  unsigned const         interval;
+  async_when_pending_worker_t worker{};
+  async_context_t*            context = nullptr;
+
+  static void do_work(async_context_t*, async_when_pending_worker_t* worker)
+  {
+    static_cast<Derived*>(reinterpret_cast<PendingWorkerTask*>(worker->user_data))->run_pending();
+  }
+
+  void bind()
+  {
+    worker.do_work   = do_work;
+    worker.user_data = reinterpret_cast<void*>(this);
+  }
+
+protected:
+  PendingWorkerTask() { bind(); }
+
+  /**
+   * @brief Move constructor; tasks must be moved before they are attached
+   */
+  PendingWorkerTask(PendingWorkerTask&& other)
+    : RunReporter(other)
+  {
+    bind();
+    worker.work_pending = static_cast<bool>(other.worker.work_pending);
+  }
 
 public:
+  PendingWorkerTask& operator=(PendingWorkerTask&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  PendingWorkerTask(const PendingWorkerTask&)            = delete;
+  PendingWorkerTask& operator=(const PendingWorkerTask&) = delete;
+
   /**
-   * @brief Constructs a ScheduledTask with the given interval and callback
+   * @brief Adds the task to an async context; called by TaskRunner
    *
-   * @param interval The interval in milliseconds at which to run the task
-   * @param callback The function to call when the task is executed
+   * @param async_context The context whose poll runs the task
    */
-  ScheduledTask(unsigned interval, F&& callback)
-    : callback(std::forward<F>(callback))
-    , interval(interval)
+  void attach(async_context_t& async_context)
   {
-    // Create worker
-    worker = { .do_work =
-                 [](async_context_t* context, async_at_time_worker_t* worker)
-               {
-                 auto* self = reinterpret_cast<ScheduledTask*>(worker->user_data);
-                 self->callback();
-                 async_context_add_at_time_worker_in_ms(context, worker, self->interval);
-               },
-               .user_data = reinterpret_cast<void*>(this) };
+    context = &async_context;
+    async_context_add_when_pending_worker(context, &worker);
+    if (worker.work_pending)
+    {
+      // Signalled before it was attached; wake the context as that signal would have
+      async_context_set_work_pending(context, &worker);
+    }
   }
 
   /**
-   * @brief Gets the current interval for the task
+   * @brief Removes the task from an async context; called by TaskRunner
    *
-   * @return The current interval in milliseconds
+   * @param async_context The context the task was attached to
    */
-  unsigned get_interval() const
+  void detach(async_context_t& async_context)
   {
-    return interval;
+    async_context_remove_when_pending_worker(&async_context, &worker);
+    context = nullptr;
   }
 
-  // Allow moving
-  ScheduledTask(ScheduledTask&&)            = default;
-  ScheduledTask& operator=(ScheduledTask&&) = default;
-
-  // Prevent copying to avoid resource management issues
-  ScheduledTask(const ScheduledTask&)            = delete;
-  ScheduledTask& operator=(const ScheduledTask&) = delete;
+  /**
+   * @brief Requests a run of the task on the next poll
+   *
+   * Lock-free and safe to call from an ISR, the other core or another thread.
+   */
+  void signal()
+  {
+    if (context)
+    {
+      async_context_set_work_pending(context, &worker);
+    }
+    else
+    {
+      // Not attached yet; the first poll after attaching runs it
+      worker.work_pending = true;
+    }
+  }
 
   /**
    * @brief Gets the native worker for this task
    *
-   * @return Reference to the async_at_time_worker_t
+   * @return Reference to the async_when_pending_worker_t
    */
   auto& get_native_worker() { return worker; }
 };
 
+/**
+ * @brief Task that runs once on the next poll after it has been signalled
+ *
+ * Backed by an SDK when-pending worker, so no timer is involved: signal() marks
+ * the work pending and wakes a loop sleeping in wait_for_work_until. Signals
+ * that arrive before the task has run are coalesced into one run.
+ *
+ * @tparam F The type of the callable object
+ */
+template<TaskCallable F>
+class EventTask : public PendingWorkerTask<EventTask<F>>
+{
+private:
+  friend class PendingWorkerTask<EventTask>;
+
+  F callback;
+
+  void run_pending()
+  {
+    this->report_run();
+    callback();
+  }
+
+public:
+  /**
+   * @brief Constructs an EventTask with the given callback
+   *
+   * @param callback The function to call after each signal
+   */
+  explicit EventTask(F&& callback)
+    : callback(std::forward<F>(callback))
+  {
+  }
+
+  /**
+   * @brief Move constructor; tasks must be moved before they are attached
+   */
+  EventTask(EventTask&& other)
+    : PendingWorkerTask<EventTask>(std::move(other))
+    , callback(std::forward<F>(other.callback))
+  {
+  }
+  EventTask& operator=(EventTask&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  EventTask(const EventTask&)            = delete;
+  EventTask& operator=(const EventTask&) = delete;
+};
+
+/**
+ * @brief Creates an event task with the given callback
+ *
+ * @tparam F The type of the callable object
+ * @param callback The function to call after each signal
+ * @return An EventTask object
+ */
+template<TaskCallable F>
+auto create_event_task(F&& callback)
+{
+  return EventTask<F>(std::forward<F>(callback));
+}
+
 /**
  * @brief Creates a scheduled task with the given interval and callback
  *
  * @param interval The interval in milliseconds at which to run the task
  * @tparam F The type of the callable object
  * @param callback The function to call when the task is executed
+ * @param policy How the next deadline is computed after each run
+ * @param priority Dispatch priority in DispatchMode::priority; higher runs first
+ * @return A ScheduledTask object
+ */
+template<TaskCallable F>
+auto create_scheduled_task(unsigned       interval,
+                           F&&            callback,
+                           SchedulePolicy policy   = SchedulePolicy::relative,
+                           uint8_t        priority = 0)
+{
+  return ScheduledTask<F>(interval, std::forward<F>(callback), policy, priority);
+}
+
+/**
+ * @brief Creates a scheduled task with the given period and callback
+ *
+ * @param period The period at which to run the task, e.g. std::chrono::microseconds{ 250 }
+ * @tparam F The type of the callable object
+ * @param callback The function to call when the task is executed
+ * @param policy How the next deadline is computed after each run
+ * @param priority Dispatch priority in DispatchMode::priority; higher runs first
  * @return A ScheduledTask object
  */
+template<typename Rep, typename Period, TaskCallable F>
+auto create_scheduled_task(std::chrono::duration<Rep, Period> period,
+                           F&&                                callback,
+                           SchedulePolicy                     policy   = SchedulePolicy::relative,
+                           uint8_t                            priority = 0)
+{
+  return ScheduledTask<F>(period, std::forward<F>(callback), policy, priority);
+}
+
+/**
+ * @brief Creates a scheduled task whose interval is a compile-time constant
+ *
+ * The period is part of the task type, e.g. create_scheduled_task<500>(callback)
+ * or create_scheduled_task<250, SchedulePolicy::skip, std::chrono::microseconds>(callback).
+ *
+ * @tparam Interval The interval in units of Unit
+ * @tparam Policy How the next deadline is computed after each run
+ * @tparam Unit The std::chrono duration type of the interval, milliseconds by default
+ * @param callback The function to call when the task is executed
+ * @return A FixedPeriodTask object
+ */
+template<unsigned       Interval,
+         SchedulePolicy Policy = SchedulePolicy::relative,
+         typename Unit         = std::chrono::milliseconds,
+         TaskCallable F>
+auto create_scheduled_task(F&& callback)
+{
+  constexpr uint64_t period_us = std::chrono::duration_cast<std::chrono::microseconds>(Unit{ Interval }).count();
+  return FixedPeriodTask<period_us, F, Policy>(std::forward<F>(callback));
+}
+
+/**
+ * @brief Describes a scheduled task for a TaskRunner to construct in place
+ *
+ * @param interval The interval in milliseconds at which to run the task
+ * @tparam F The type of the callable object
+ * @param callback The function to call when the task is executed
+ * @param policy How the next deadline is computed after each run
+ * @param priority Dispatch priority in DispatchMode::priority; higher runs first
+ * @return A ScheduledTaskDescriptor to pass to the TaskRunner constructor
+ */
 template<TaskCallable F>
-auto create_scheduled_task(unsigned interval, F&& callback)
+auto task_descriptor(unsigned       interval,
+                     F&&            callback,
+                     SchedulePolicy policy   = SchedulePolicy::relative,
+                     uint8_t        priority = 0)
+{
+  return ScheduledTaskDescriptor<F>{ std::chrono::milliseconds{ interval }, std::forward<F>(callback), policy, priority };
+}
+
+/**
+ * @brief Describes a scheduled task with the given period for a TaskRunner to construct in place
+ *
+ * @param period The period at which to run the task, e.g. std::chrono::microseconds{ 250 }
+ * @tparam F The type of the callable object
+ * @param callback The function to call when the task is executed
+ * @param policy How the next deadline is computed after each run
+ * @param priority Dispatch priority in DispatchMode::priority; higher runs first
+ * @return A ScheduledTaskDescriptor to pass to the TaskRunner constructor
+ */
+template<typename Rep, typename Period, TaskCallable F>
+auto task_descriptor(std::chrono::duration<Rep, Period> period,
+                     F&&                                callback,
+                     SchedulePolicy                     policy   = SchedulePolicy::relative,
+                     uint8_t                            priority = 0)
 {
-  return ScheduledTask<F>(interval, std::forward<F>(callback));
+  return ScheduledTaskDescriptor<F>{ std::chrono::duration_cast<std::chrono::microseconds>(period),
+                                     std::forward<F>(callback),
+                                     policy,
+                                     priority };
 }
+
+/**
+ * @brief The task type a TaskRunner stores for a constructor argument
+ */
+template<typename T>
+struct runner_task
+{
+  using type = std::remove_cvref_t<T>;
+};
+
+template<TaskCallable F>
+struct runner_task<ScheduledTaskDescriptor<F>>
+{
+  using type = ScheduledTask<F>;
+};
+
+template<typename T>
+using runner_task_t = typename runner_task<std::remove_cvref_t<T>>::type;
+
+template<typename... Args>
+TaskRunner(Args&&...) -> TaskRunner<runner_task_t<Args>...>;
+
+template<typename... Args>
+TaskRunner(async_context_t&, Args&&...) -> TaskRunner<runner_task_t<Args>...>;
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Handle to a task spawned in a TaskPool
+ *
+ * Stays safe to use after the task has finished or been cancelled: the slot
+ * generation no longer matches, so cancel() and is_active() see a stale
+ * handle instead of whichever task reuses the slot.
+ */
+struct PoolTaskHandle
+{
+  static constexpr uint16_t invalid_index = UINT16_MAX;
+
+  uint16_t index      = invalid_index;
+  uint16_t generation = 0;
+
+  /**
+   * @brief Checks whether spawning succeeded; false when the pool was full
+   */
+  explicit operator bool() const { return index != invalid_index; }
+};
+
+/**
+ * @brief Fixed-capacity pool of tasks that are spawned and cancelled at runtime
+ *
+ * Every slot holds an SDK worker and StorageBytes of inline storage for the
+ * callable, so spawning never allocates. Free slots form an intrusive list,
+ * making spawn() and cancel() O(1) apart from adding or removing the worker
+ * in the async context. Spawned tasks run directly from the async context
+ * poll, like EventTask, and are not ordered by the runner's dispatch mode.
+ *
+ * The pool is itself a task: pass it to a TaskRunner, which adds it to its
+ * context, and reach it through get_task<I>(). A pool may be moved only
+ * before it is attached.
+ *
+ * @tparam N Number of slots
+ * @tparam StorageBytes Largest callable a slot can hold
+ */
+template<std::size_t N, std::size_t StorageBytes = 32>
+class TaskPool : public RunReporter
+{
+  static_assert(N > 0 && N < PoolTaskHandle::invalid_index, "a pool holds between 1 and 65534 tasks");
+
+  // Type-erased operations on the callable stored in a slot
+  struct Operations
+  {
+    void (*invoke)(void* storage);
+    void (*destroy)(void* storage);
+    void (*relocate)(void* from, void* to);
+  };
+
+  template<typename F>
+  static constexpr Operations operations_for{
+    [](void* storage) { (*static_cast<F*>(storage))(); },
+    [](void* storage) { static_cast<F*>(storage)->~F(); },
+    [](void* from, void* to)
+    {
+      ::new (to) F(std::move(*static_cast<F*>(from)));
+      static_cast<F*>(from)->~F();
+    },
+  };
+
+  struct Slot
+  {
+    // Must stay first: the worker pointer passed to do_work is the slot address
+    async_at_time_worker_t worker{};
+    Operations const*      operations = nullptr;  // nullptr while the slot is free
+    uint64_t               period_us  = 0;        // 0 for one-shot tasks
+    uint16_t               generation = 0;
+    uint16_t               next_free  = PoolTaskHandle::invalid_index;
+    bool                   cancelled  = false;    // cancelled from its own callback
+    alignas(std::max_align_t) unsigned char storage[StorageBytes];
+  };
+
+  static_assert(std::is_standard_layout_v<Slot>, "the worker must be the first member of a slot");
+
+  std::array<Slot, N> slots;
+  async_context_t*    context   = nullptr;
+  Slot*               running   = nullptr;
+  uint16_t            free_head = 0;
+  uint16_t            active    = 0;
+
+  static void do_work(async_context_t* async_context, async_at_time_worker_t* worker)
+  {
+    auto* const pool = static_cast<TaskPool*>(worker->user_data);
+    Slot&       slot = *reinterpret_cast<Slot*>(worker);
+
+    pool->report_run();
+    pool->running = &slot;
+    slot.operations->invoke(slot.storage);
+    pool->running = nullptr;
+
+    if (slot.cancelled || slot.period_us == 0)
+    {
+      pool->release(slot);
+      return;
+    }
+    async_context_add_at_time_worker_at(async_context,
+                                        worker,
+                                        next_deadline_after(worker->next_time, slot.period_us, SchedulePolicy::skip));
+  }
+
+  uint16_t index_of(Slot const& slot) const { return static_cast<uint16_t>(&slot - slots.data()); }
+
+  /**
+   * @brief Destroys the callable and returns the slot to the free list
+   */
+  void release(Slot& slot)
+  {
+    slot.operations->destroy(slot.storage);
+    slot.operations = nullptr;
+    slot.cancelled  = false;
+    slot.generation++;
+    slot.next_free = free_head;
+    free_head      = index_of(slot);
+    active--;
+  }
+
+  void init_free_list()
+  {
+    for (std::size_t i = 0; i < N; i++)
+    {
+      slots[i].worker.do_work   = do_work;
+      slots[i].worker.user_data = reinterpret_cast<void*>(this);
+      slots[i].next_free        = static_cast<uint16_t>(i + 1 < N ? i + 1 : PoolTaskHandle::invalid_index);
+    }
+  }
+
+  Slot* find(PoolTaskHandle handle)
+  {
+    if (handle.index >= N)
+    {
+      return nullptr;
+    }
+    Slot& slot = slots[handle.index];
+    return slot.operations && slot.generation == handle.generation && !slot.cancelled ? &slot : nullptr;
+  }
+
+public:
+  static constexpr std::size_t capacity      = N;
+  static constexpr std::size_t storage_bytes = StorageBytes;
+
+  TaskPool() { init_free_list(); }
+
+  /**
+   * @brief Move constructor; pools must be moved before they are attached
+   */
+  TaskPool(TaskPool&& other)
+    : RunReporter(other)
+    , free_head(other.free_head)
+    , active(other.active)
+  {
+    init_free_list();
+    for (std::size_t i = 0; i < N; i++)
+    {
+      Slot& from             = other.slots[i];
+      Slot& to               = slots[i];
+      to.worker.next_time    = from.worker.next_time;
+      to.period_us           = from.period_us;
+      to.generation          = from.generation;
+      to.next_free           = from.next_free;
+      if (from.operations)
+      {
+        from.operations->relocate(from.storage, to.storage);
+        to.operations   = from.operations;
+        from.operations = nullptr;
+      }
+    }
+    other.active = 0;
+  }
+  TaskPool& operator=(TaskPool&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  TaskPool(const TaskPool&)            = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  ~TaskPool()
+  {
+    for (Slot& slot : slots)
+    {
+      if (slot.operations)
+      {
+        if (context)
+        {
+          async_context_remove_at_time_worker(context, &slot.worker);
+        }
+        slot.operations->destroy(slot.storage);
+      }
+    }
+  }
+
+  /**
+   * @brief Adds the tasks spawned so far to an async context; called by TaskRunner
+   *
+   * @param async_context The context whose poll runs the tasks
+   */
+  void attach(async_context_t& async_context)
+  {
+    context = &async_context;
+    for (Slot& slot : slots)
+    {
+      if (slot.operations)
+      {
+        async_context_add_at_time_worker_at(context, &slot.worker, slot.worker.next_time);
+      }
+    }
+  }
+
+  /**
+   * @brief Starts a task in a free slot
+   *
+   * The callable is moved into the slot; it must fit in StorageBytes. Safe to
+   * call from a task, including one running in this pool, but not from an ISR.
+   *
+   * @param callback The function to run
+   * @param delay Time until the first run; 0 runs it on the next poll
+   * @param period Time between runs, on a fixed grid that skips missed periods; 0 runs it once
+   * @return A handle to the task, or an invalid handle if every slot is taken or a duration is negative
+   */
+  template<typename F>
+    requires TaskCallable<std::decay_t<F>>
+  PoolTaskHandle spawn(F&&                       callback,
+                       std::chrono::microseconds delay  = std::chrono::microseconds{ 0 },
+                       std::chrono::microseconds period = std::chrono::microseconds{ 0 })
+  {
+    using Callable = std::decay_t<F>;
+    static_assert(sizeof(Callable) <= StorageBytes, "the callable does not fit in a pool slot; raise StorageBytes");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "the callable is over-aligned for a pool slot");
+
+    if (free_head == PoolTaskHandle::invalid_index || delay.count() < 0 || period.count() < 0)
+    {
+      return PoolTaskHandle{};
+    }
+    Slot& slot = slots[free_head];
+    free_head  = slot.next_free;
+    active++;
+
+    ::new (static_cast<void*>(slot.storage)) Callable(std::forward<F>(callback));
+    slot.operations       = &operations_for<Callable>;
+    slot.period_us        = static_cast<uint64_t>(period.count());
+    slot.worker.next_time = make_timeout_time_us(static_cast<uint64_t>(delay.count()));
+    if (context)
+    {
+      async_context_add_at_time_worker_at(context, &slot.worker, slot.worker.next_time);
+    }
+    return PoolTaskHandle{ index_of(slot), slot.generation };
+  }
+
+  /**
+   * @brief Stops a task and frees its slot
+   *
+   * A task may cancel itself from its callback; its slot is then freed once
+   * the callback returns.
+   *
+   * @param handle The handle returned by spawn()
+   * @return true if the task was still active
+   */
+  bool cancel(PoolTaskHandle handle)
+  {
+    Slot* const slot = find(handle);
+    if (!slot)
+    {
+      return false;
+    }
+    if (slot == running)
+    {
+      slot->cancelled = true;
+      return true;
+    }
+    if (context)
+    {
+      async_context_remove_at_time_worker(context, &slot->worker);
+    }
+    release(*slot);
+    return true;
+  }
+
+  /**
+   * @brief Checks whether a task is still scheduled to run
+   *
+   * @param handle The handle returned by spawn()
+   * @return false once a one-shot task has run or any task has been cancelled
+   */
+  bool is_active(PoolTaskHandle handle) { return find(handle) != nullptr; }
+
+  /**
+   * @brief Gets the number of slots in use
+   */
+  std::size_t size() const { return active; }
+};
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Alignment that keeps the producer and consumer indices of a queue apart
+ *
+ * The RP2040 has no data cache, so padding would only waste RAM; hosts and
+ * cached cores get a full line to avoid false sharing.
+ */
+#if defined(__ARM_ARCH_6M__)
+#define MAMETASK_QUEUE_ALIGN 4
+#else
+#define MAMETASK_QUEUE_ALIGN 64
+#endif
+
+/**
+ * @brief Wakes the task that consumes a queue; shared by SpscQueue and MpscQueue
+ */
+class QueueConsumer
+{
+private:
+  void (*signal_consumer)(void* task) = nullptr;
+  void* task                          = nullptr;
+
+public:
+  /**
+   * @brief Makes every successful push signal an event task
+   *
+   * Set it before producers start, typically with the task returned by
+   * TaskRunner::get_task<I>(), whose callback drains the queue.
+   *
+   * @param consumer The task to signal
+   */
+  template<typename Task>
+  void set_consumer(Task& consumer)
+  {
+    task            = &consumer;
+    signal_consumer = [](void* target) { static_cast<Task*>(target)->signal(); };
+  }
+
+  /**
+   * @brief Signals the consumer, if one is set
+   */
+  void notify() const
+  {
+    if (signal_consumer)
+    {
+      signal_consumer(task);
+    }
+  }
+};
+
+/**
+ * @brief Fixed-capacity lock-free queue for one producer and one consumer
+ *
+ * Suitable for an ISR or the other core feeding a task. The producer only
+ * writes the tail and the consumer only writes the head; each publishes its
+ * index with a release store and reads the other's with an acquire load, so
+ * an element is fully written before the consumer can see it and fully read
+ * before the producer can overwrite it. Only plain 32-bit loads and stores
+ * are needed, which are lock-free on every RP2040 and RP2350 core.
+ *
+ * @tparam T The element type
+ * @tparam Capacity Maximum number of queued elements; a power of two
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue : public QueueConsumer
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+  static_assert(Capacity <= (std::size_t{ 1 } << 31), "the capacity must fit in a 32-bit index");
+  static_assert(std::is_default_constructible_v<T>, "the ring holds default-constructed elements");
+
+  static constexpr uint32_t mask = Capacity - 1;
+
+  alignas(MAMETASK_QUEUE_ALIGN) std::atomic<uint32_t> head{ 0 };  // written by the consumer
+  alignas(MAMETASK_QUEUE_ALIGN) std::atomic<uint32_t> tail{ 0 };  // written by the producer
+  alignas(MAMETASK_QUEUE_ALIGN) T slots[Capacity];
+
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  SpscQueue() = default;
+
+  // The indices are shared with other contexts, so the queue stays in place
+  SpscQueue(const SpscQueue&)            = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * @brief Appends an element and signals the consumer; producer side only
+   *
+   * @param value The element to append
+   * @return false if the queue is full
+   */
+  template<typename U>
+  bool push(U&& value)
+  {
+    uint32_t const position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == Capacity)
+    {
+      return false;
+    }
+    slots[position & mask] = std::forward<U>(value);
+    tail.store(position + 1, std::memory_order_release);
+    notify();
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest element; consumer side only
+   *
+   * @param value Receives the element
+   * @return false if the queue is empty
+   */
+  bool pop(T& value)
+  {
+    uint32_t const position = head.load(std::memory_order_relaxed);
+    if (position == tail.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    value = std::move(slots[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops every element queued so far and passes it to a handler; consumer side only
+   *
+   * @param handler Called with each element, oldest first
+   * @return The number of elements handled
+   */
+  template<typename F>
+  std::size_t drain(F&& handler)
+  {
+    std::size_t count = 0;
+    T           value;
+    while (pop(value))
+    {
+      handler(std::move(value));
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Gets the number of queued elements; exact only when called by the consumer or producer while the other is idle
+   */
+  std::size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+  bool empty() const { return size() == 0; }
+};
+
+/**
+ * @brief Fixed-capacity queue for several producers and one consumer
+ *
+ * A bounded ring with one sequence number per cell (Vyukov). Producers
+ * claim a cell by advancing the tail with a compare-and-swap, write the
+ * element and then release the cell's sequence number; the consumer
+ * acquires the sequence number before reading and releases the cell back to
+ * the producers one lap ahead. A producer that is interrupted between
+ * claiming and publishing only delays the consumer at that cell.
+ *
+ * On the RP2040 (Cortex-M0+), compare-and-swap is provided by the SDK's
+ * atomic helpers, which briefly disable interrupts and take a hardware
+ * spin lock; on the RP2350 and on hosts it is a native lock-free
+ * instruction sequence.
+ *
+ * @tparam T The element type
+ * @tparam Capacity Maximum number of queued elements; a power of two
+ */
+template<typename T, std::size_t Capacity>
+class MpscQueue : public QueueConsumer
+{
+  static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two of at least 2");
+  static_assert(Capacity <= (std::size_t{ 1 } << 31), "the capacity must fit in a 32-bit index");
+  static_assert(std::is_default_constructible_v<T>, "the ring holds default-constructed elements");
+
+  static constexpr uint32_t mask = Capacity - 1;
+
+  struct Cell
+  {
+    std::atomic<uint32_t> sequence;
+    T                     value;
+  };
+
+  alignas(MAMETASK_QUEUE_ALIGN) std::atomic<uint32_t> tail{ 0 };  // shared by the producers
+  alignas(MAMETASK_QUEUE_ALIGN) uint32_t head = 0;                // owned by the consumer
+  alignas(MAMETASK_QUEUE_ALIGN) Cell cells[Capacity];
+
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  MpscQueue()
+  {
+    for (uint32_t i = 0; i < Capacity; i++)
+    {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // The cells are shared with other contexts, so the queue stays in place
+  MpscQueue(const MpscQueue&)            = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+   * @brief Appends an element and signals the consumer; safe from any number of producers
+   *
+   * @param value The element to append
+   * @return false if the queue is full
+   */
+  template<typename U>
+  bool push(U&& value)
+  {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    Cell*    cell;
+    while (true)
+    {
+      cell                    = &cells[position & mask];
+      uint32_t const sequence = cell->sequence.load(std::memory_order_acquire);
+      int32_t const  lag      = static_cast<int32_t>(sequence - position);
+      if (lag == 0)
+      {
+        // The cell is free on this lap; claim it
+        if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (lag < 0)
+      {
+        // The consumer has not freed the cell from the previous lap
+        return false;
+      }
+      else
+      {
+        position = tail.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::forward<U>(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    notify();
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest published element; consumer side only
+   *
+   * @param value Receives the element
+   * @return false if the queue is empty or the next element is still being written
+   */
+  bool pop(T& value)
+  {
+    Cell& cell = cells[head & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+    {
+      return false;
+    }
+    value = std::move(cell.value);
+    cell.sequence.store(head + Capacity, std::memory_order_release);
+    head++;
+    return true;
+  }
+
+  /**
+   * @brief Pops every published element and passes it to a handler; consumer side only
+   *
+   * @param handler Called with each element, in the order the producers claimed their cells
+   * @return The number of elements handled
+   */
+  template<typename F>
+  std::size_t drain(F&& handler)
+  {
+    std::size_t count = 0;
+    T           value;
+    while (pop(value))
+    {
+      handler(std::move(value));
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Gets the number of claimed elements, including any still being written; consumer side only
+   */
+  std::size_t size() const { return tail.load(std::memory_order_acquire) - head; }
+
+  bool empty() const { return size() == 0; }
+};
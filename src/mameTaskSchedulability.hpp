@@ -0,0 +1,258 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Compile-time timing annotation of a task
+ *
+ * Times are in microseconds. For sporadic tasks such as EventTask, period_us
+ * is the minimum time between two signals.
+ */
+struct TaskTiming
+{
+  uint64_t period_us;         ///< release period
+  uint64_t wcet_us;           ///< worst-case execution time of one run
+  uint64_t deadline_us = 0;   ///< relative deadline; 0 means the period
+  uint8_t  priority    = 0;   ///< dispatch priority; higher runs first
+
+  constexpr uint64_t effective_deadline_us() const { return deadline_us ? deadline_us : period_us; }
+};
+
+/**
+ * @brief Concept for task types that carry a compile-time TaskTiming
+ */
+template<typename T>
+concept TimedTask = requires {
+  { T::timing } -> std::convertible_to<TaskTiming>;
+};
+
+/**
+ * @brief Task with a compile-time timing annotation
+ *
+ * Behaves like the wrapped task. Its priority and, where supported, its
+ * relative deadline are taken from the annotation, so the analysis and the
+ * runner's dispatch see the same values.
+ *
+ * @tparam Timing The timing annotation
+ * @tparam Task The annotated task type
+ */
+template<TaskTiming Timing, RunnableTask Task>
+class AnnotatedTask : public Task
+{
+public:
+  static constexpr TaskTiming timing = Timing;
+
+  /**
+   * @brief Wraps a task
+   *
+   * @param task The task to annotate
+   */
+  explicit AnnotatedTask(Task&& task)
+    : Task(std::move(task))
+  {
+    if constexpr (requires(Task& t) { t.set_relative_deadline(std::chrono::microseconds{}); })
+    {
+      this->set_relative_deadline(std::chrono::microseconds{ Timing.effective_deadline_us() });
+    }
+  }
+
+  AnnotatedTask(AnnotatedTask&&) = default;
+
+  /**
+   * @brief Gets the dispatch priority from the annotation
+   */
+  uint8_t get_priority() const { return Timing.priority; }
+};
+
+/**
+ * @brief Annotates a task with compile-time timing
+ *
+ * @tparam Timing The timing annotation
+ * @param task The task to annotate
+ * @return An AnnotatedTask object
+ */
+template<TaskTiming Timing, RunnableTask Task>
+auto annotate(Task&& task)
+{
+  return AnnotatedTask<Timing, std::remove_cvref_t<Task>>(std::move(task));
+}
+
+/**
+ * @brief Creates a periodic task whose period, priority and deadline come from a timing annotation
+ *
+ * @tparam Timing The timing annotation
+ * @param callback The function to call when the task is executed
+ * @param policy How the next deadline is computed after each run
+ * @return An AnnotatedTask wrapping a ScheduledTask
+ */
+template<TaskTiming Timing, TaskCallable F>
+auto create_timed_task(F&& callback, SchedulePolicy policy = SchedulePolicy::relative)
+{
+  return annotate<Timing>(
+    ScheduledTask<F>(std::chrono::microseconds{ Timing.period_us }, std::forward<F>(callback), policy, Timing.priority)
+  );
+}
+
+/**
+ * @brief constexpr schedulability tests over a set of task timings
+ *
+ * Tasks are dispatched cooperatively, so a task can be blocked by one run of
+ * a lower-priority task that has already started. Ties in priority are
+ * broken by position, as in TaskRunner.
+ */
+namespace schedulability
+{
+  /**
+   * @brief Total processor utilization, the sum of wcet / period
+   */
+  template<std::size_t N>
+  constexpr double utilization(std::array<TaskTiming, N> const& tasks)
+  {
+    double total = 0.0;
+    for (TaskTiming const& task : tasks)
+    {
+      total += static_cast<double>(task.wcet_us) / static_cast<double>(task.period_us);
+    }
+    return total;
+  }
+
+  /**
+   * @brief Liu & Layland rate-monotonic bound, U <= n (2^(1/n) - 1)
+   *
+   * Sufficient for preemptive rate-monotonic scheduling with deadlines equal
+   * to periods. It ignores the blocking of cooperative dispatch; use
+   * fixed_priority() for the runner.
+   */
+  template<std::size_t N>
+  constexpr bool liu_layland(std::array<TaskTiming, N> const& tasks)
+  {
+    // U <= n (2^(1/n) - 1)  <=>  (1 + U / n)^n <= 2
+    double const per_task = 1.0 + utilization(tasks) / static_cast<double>(N);
+    double       power    = 1.0;
+    for (std::size_t i = 0; i < N; i++)
+    {
+      power *= per_task;
+    }
+    return power <= 2.0;
+  }
+
+  /**
+   * @brief Whether task j is dispatched before task i when both are ready
+   */
+  template<std::size_t N>
+  constexpr bool runs_before(std::array<TaskTiming, N> const& tasks, std::size_t j, std::size_t i)
+  {
+    return tasks[j].priority > tasks[i].priority || (tasks[j].priority == tasks[i].priority && j < i);
+  }
+
+  /**
+   * @brief Worst-case response time of a task under cooperative fixed-priority dispatch
+   *
+   * Sufficient non-preemptive response-time analysis (Davis et al., 2007):
+   * w = max(B, C) + sum over higher-priority j of (floor(w / T_j) + 1) C_j and
+   * R = w + C, where B is the longest lower-priority WCET.
+   *
+   * @return The response time in microseconds, or UINT64_MAX if it exceeds the deadline
+   */
+  template<std::size_t N>
+  constexpr uint64_t response_time_us(std::array<TaskTiming, N> const& tasks, std::size_t i)
+  {
+    uint64_t blocking = tasks[i].wcet_us;
+    for (std::size_t k = 0; k < N; k++)
+    {
+      if (k != i && !runs_before(tasks, k, i) && tasks[k].wcet_us > blocking)
+      {
+        blocking = tasks[k].wcet_us;
+      }
+    }
+
+    uint64_t const deadline = tasks[i].effective_deadline_us();
+    uint64_t       start    = blocking;
+    while (true)
+    {
+      uint64_t next = blocking;
+      for (std::size_t j = 0; j < N; j++)
+      {
+        if (j != i && runs_before(tasks, j, i))
+        {
+          next += (start / tasks[j].period_us + 1) * tasks[j].wcet_us;
+        }
+      }
+      if (next + tasks[i].wcet_us > deadline)
+      {
+        return UINT64_MAX;
+      }
+      if (next == start)
+      {
+        return next + tasks[i].wcet_us;
+      }
+      start = next;
+    }
+  }
+
+  /**
+   * @brief Whether every task meets its deadline under DispatchMode::priority
+   */
+  template<std::size_t N>
+  constexpr bool fixed_priority(std::array<TaskTiming, N> const& tasks)
+  {
+    for (std::size_t i = 0; i < N; i++)
+    {
+      if (response_time_us(tasks, i) == UINT64_MAX)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief EDF utilization test, sum of wcet / min(deadline, period) <= 1
+   *
+   * Exact for preemptive EDF with deadlines equal to periods and sufficient
+   * with shorter deadlines. Cooperative dispatch can additionally delay a run
+   * by the longest WCET in the set.
+   */
+  template<std::size_t N>
+  constexpr bool edf(std::array<TaskTiming, N> const& tasks)
+  {
+    double density = 0.0;
+    for (TaskTiming const& task : tasks)
+    {
+      uint64_t const window = task.effective_deadline_us() < task.period_us ? task.effective_deadline_us() : task.period_us;
+      density += static_cast<double>(task.wcet_us) / static_cast<double>(window);
+    }
+    return density <= 1.0;
+  }
+}
+
+/**
+ * @brief Compile-time schedulability of a task set
+ *
+ * Instantiate with the task types or with a TaskRunner type, e.g.
+ * static_assert(TaskSetAnalysis<decltype(runner)>::fixed_priority).
+ * Every task must carry a TaskTiming annotation.
+ */
+template<typename... Tasks>
+struct TaskSetAnalysis
+{
+  static_assert((TimedTask<Tasks> && ...), "every task needs a TaskTiming annotation, see annotate()");
+
+  static constexpr std::array<TaskTiming, sizeof...(Tasks)> timings{ Tasks::timing... };
+
+  static constexpr double utilization    = schedulability::utilization(timings);
+  static constexpr bool   liu_layland    = schedulability::liu_layland(timings);
+  static constexpr bool   fixed_priority = schedulability::fixed_priority(timings);
+  static constexpr bool   edf            = schedulability::edf(timings);
+};
+
+template<typename... Tasks>
+struct TaskSetAnalysis<TaskRunner<Tasks...>> : TaskSetAnalysis<Tasks...>
+{
+};
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "mameTaskPico.hpp"
+#include "mameTaskTimingWheel.hpp"
+
+/**
+ * @brief Function called when a soft timer expires
+ */
+using SoftTimerCallback = void (*)(void* user_data);
+
+/**
+ * @brief Stable handle to a timer created in SoftTimers
+ *
+ * Stays valid until the timer is destroyed, across any number of restarts.
+ */
+struct SoftTimerHandle
+{
+  static constexpr uint16_t invalid_index = UINT16_MAX;
+
+  uint16_t index = invalid_index;
+
+  /**
+   * @brief Checks whether creating the timer succeeded; false when every timer was taken
+   */
+  explicit operator bool() const { return index != invalid_index; }
+};
+
+/**
+ * @brief Restartable one-shot timers for timeouts that are mostly cancelled or restarted before they fire
+ *
+ * All timers share one TimingWheel and a single SDK worker, which is queued
+ * for the earliest wheel event. Restarting a timer to a later deadline only
+ * records the new deadline; the timer stays in its wheel slot and is moved
+ * to the right one when the old slot comes due (lazy deletion). Restarting
+ * it earlier and cancelling it unlink the node, which is O(1) on the wheel.
+ * The async context is only touched when the earliest event moves earlier,
+ * so restart-heavy protocols (ACK, debounce and inactivity timers) do not
+ * re-sort the context's timer queue on every restart.
+ *
+ * Like TaskPool, the object is a task: pass it to a TaskRunner and reach it
+ * through get_task<I>(). Deadlines are rounded up to the tick, so timers never
+ * fire early. Callbacks run from the async context poll and may restart,
+ * cancel or destroy any timer, including their own.
+ *
+ * @tparam N Number of timers
+ * @tparam TickUs Wheel resolution in microseconds
+ */
+template<std::size_t N, uint32_t TickUs = 1000>
+class SoftTimers : public RunReporter
+{
+  static_assert(N > 0 && N < SoftTimerHandle::invalid_index, "between 1 and 65534 soft timers are supported");
+  static_assert(TickUs > 0, "the tick must be at least 1us");
+
+  struct Timer : TimingWheel::Node
+  {
+    SoftTimerCallback callback  = nullptr;  // nullptr while the timer is not created
+    void*             user_data = nullptr;
+    uint64_t          deadline  = 0;  // tick at which the timer is due; its wheel expiry may be earlier
+    bool              running   = false;
+    uint16_t          next_free = SoftTimerHandle::invalid_index;
+  };
+
+  async_at_time_worker_t worker{};
+  async_context_t*       context = nullptr;
+  TimingWheel            wheel;
+  std::array<Timer, N>   timers;
+  uint64_t               queued_tick = TimingWheel::never;  // tick the worker is queued for
+  uint16_t               free_head   = 0;
+
+  static uint64_t current_tick() { return to_us_since_boot(get_absolute_time()) / TickUs; }
+
+  static uint64_t tick_after(std::chrono::microseconds delay)
+  {
+    uint64_t const due = to_us_since_boot(make_timeout_time_us(static_cast<uint64_t>(delay.count())));
+    return due / TickUs + (due % TickUs != 0);
+  }
+
+  static void do_work(async_context_t*, async_at_time_worker_t* worker)
+  {
+    auto* const self = static_cast<SoftTimers*>(worker->user_data);
+    self->report_run();
+    self->queued_tick = TimingWheel::never;
+    uint64_t const now = current_tick();
+    self->wheel.advance(now,
+                        [self, now](TimingWheel::Node& node)
+                        {
+                          Timer& timer = static_cast<Timer&>(node);
+                          if (timer.deadline > now)
+                          {
+                            // Restarted since it was placed; file it under its current deadline
+                            self->wheel.insert(timer, timer.deadline);
+                            return;
+                          }
+                          timer.running = false;
+                          timer.callback(timer.user_data);
+                        });
+    self->queue_worker();
+  }
+
+  /**
+   * @brief Queues the worker for the earliest wheel event if that is earlier than its current time
+   */
+  void queue_worker()
+  {
+    uint64_t const next = wheel.next_event_tick();
+    if (!context || next >= queued_tick)
+    {
+      return;
+    }
+    if (queued_tick != TimingWheel::never)
+    {
+      async_context_remove_at_time_worker(context, &worker);
+    }
+    queued_tick = next;
+    async_context_add_at_time_worker_at(context, &worker, from_us_since_boot(next * TickUs));
+  }
+
+  void init()
+  {
+    worker.do_work   = do_work;
+    worker.user_data = reinterpret_cast<void*>(this);
+    for (std::size_t i = 0; i < N; i++)
+    {
+      timers[i].next_free = static_cast<uint16_t>(i + 1 < N ? i + 1 : SoftTimerHandle::invalid_index);
+    }
+  }
+
+  Timer* find(SoftTimerHandle handle)
+  {
+    return handle.index < N && timers[handle.index].callback ? &timers[handle.index] : nullptr;
+  }
+
+public:
+  static constexpr std::size_t capacity = N;
+  static constexpr std::chrono::microseconds tick{ TickUs };
+
+  SoftTimers()
+    : wheel(current_tick())
+  {
+    init();
+  }
+
+  /**
+   * @brief Move constructor; the timers keep their handles and running state
+   */
+  SoftTimers(SoftTimers&& other)
+    : RunReporter(other)
+    , wheel(other.wheel.get_current_tick())
+    , free_head(other.free_head)
+  {
+    init();
+    for (std::size_t i = 0; i < N; i++)
+    {
+      Timer& from        = other.timers[i];
+      Timer& to          = timers[i];
+      to.callback        = from.callback;
+      to.user_data       = from.user_data;
+      to.deadline        = from.deadline;
+      to.running         = from.running;
+      to.next_free       = from.next_free;
+      if (TimingWheel::is_scheduled(from))
+      {
+        other.wheel.remove(from);
+        wheel.insert(to, from.expiry);
+      }
+    }
+    if (other.context && other.queued_tick != TimingWheel::never)
+    {
+      async_context_remove_at_time_worker(other.context, &other.worker);
+    }
+    context = other.context;
+    queue_worker();
+  }
+  SoftTimers& operator=(SoftTimers&&) = delete;
+
+  // Prevent copying to avoid resource management issues
+  SoftTimers(const SoftTimers&)            = delete;
+  SoftTimers& operator=(const SoftTimers&) = delete;
+
+  ~SoftTimers()
+  {
+    if (context && queued_tick != TimingWheel::never)
+    {
+      async_context_remove_at_time_worker(context, &worker);
+    }
+  }
+
+  /**
+   * @brief Adds the timers to an async context; called by TaskRunner
+   *
+   * @param async_context The context whose poll runs the timer callbacks
+   */
+  void attach(async_context_t& async_context)
+  {
+    context = &async_context;
+    queue_worker();
+  }
+
+  /**
+   * @brief Reserves a timer; it does not run until it is restarted
+   *
+   * @param callback The function to call when the timer expires
+   * @param user_data Passed to the callback
+   * @return A handle to the timer, or an invalid handle if every timer is taken
+   */
+  SoftTimerHandle create(SoftTimerCallback callback, void* user_data = nullptr)
+  {
+    if (free_head == SoftTimerHandle::invalid_index || !callback)
+    {
+      return SoftTimerHandle{};
+    }
+    uint16_t const index = free_head;
+    Timer&         timer = timers[index];
+    free_head            = timer.next_free;
+    timer.callback       = callback;
+    timer.user_data      = user_data;
+    timer.running        = false;
+    return SoftTimerHandle{ index };
+  }
+
+  /**
+   * @brief Stops a timer and returns it to the free timers; the handle becomes invalid
+   *
+   * @param handle The handle returned by create()
+   */
+  void destroy(SoftTimerHandle handle)
+  {
+    Timer* const timer = find(handle);
+    if (!timer)
+    {
+      return;
+    }
+    cancel(handle);
+    timer->callback  = nullptr;
+    timer->next_free = free_head;
+    free_head        = handle.index;
+  }
+
+  /**
+   * @brief Starts a timer, or moves its deadline if it is already running
+   *
+   * O(1): a later deadline is only recorded, an earlier one moves the timer
+   * to another wheel slot.
+   *
+   * @param handle The handle returned by create()
+   * @param delay Time from now until the timer expires
+   * @return false if the handle does not refer to a created timer or the delay is negative
+   */
+  bool restart(SoftTimerHandle handle, std::chrono::microseconds delay)
+  {
+    Timer* const timer = find(handle);
+    if (!timer || delay.count() < 0)
+    {
+      return false;
+    }
+    uint64_t const deadline = tick_after(delay);
+    timer->deadline         = deadline;
+    timer->running          = true;
+    if (!TimingWheel::is_scheduled(*timer))
+    {
+      wheel.insert(*timer, deadline);
+    }
+    else if (deadline < timer->expiry)
+    {
+      wheel.remove(*timer);
+      wheel.insert(*timer, deadline);
+    }
+    else
+    {
+      // Lazy: the timer is re-filed when its current slot comes due
+      return true;
+    }
+    queue_worker();
+    return true;
+  }
+
+  /**
+   * @brief Stops a timer without destroying it
+   *
+   * The worker stays queued for the earliest event, which may now cost one
+   * wakeup with nothing to do.
+   *
+   * @param handle The handle returned by create()
+   * @return true if the timer was running
+   */
+  bool cancel(SoftTimerHandle handle)
+  {
+    Timer* const timer = find(handle);
+    if (!timer || !timer->running)
+    {
+      return false;
+    }
+    timer->running = false;
+    if (TimingWheel::is_scheduled(*timer))
+    {
+      wheel.remove(*timer);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Checks whether a timer is waiting to expire
+   *
+   * @param handle The handle returned by create()
+   */
+  bool is_running(SoftTimerHandle handle) { return find(handle) && timers[handle.index].running; }
+
+  /**
+   * @brief Gets the time at which a running timer expires
+   *
+   * @param handle The handle returned by create()
+   * @return The deadline, or at_the_end_of_time if the timer is not running
+   */
+  absolute_time_t get_deadline(SoftTimerHandle handle)
+  {
+    return is_running(handle) ? from_us_since_boot(timers[handle.index].deadline * TickUs) : at_the_end_of_time;
+  }
+};
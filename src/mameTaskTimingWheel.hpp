@@ -0,0 +1,551 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <hardware/sync.h>
+
+#include "mameTaskPico.hpp"
+
+/**
+ * @brief Hierarchical hashed timing wheel over intrusive timer nodes
+ *
+ * Time is measured in integer ticks. Each level has 64 slots; level L holds
+ * the timers that expire inside the current 64^(L+1) tick block but outside
+ * the current 64^L tick block, hashed by the L-th base-64 digit of their
+ * expiry. When the wheel reaches a block, the timers of that block cascade
+ * to a lower level, so insert and cancel are O(1) and a timer is touched at
+ * most once per level before it expires. Per-level occupancy bitmaps let the
+ * wheel jump straight to the next event instead of stepping empty ticks.
+ * Timers beyond the top level wait in an overflow list that is redistributed
+ * whenever the top level wraps.
+ */
+class TimingWheel
+{
+public:
+  static constexpr unsigned level_bits      = 6;
+  static constexpr unsigned slots_per_level = 1u << level_bits;
+  static constexpr unsigned levels          = 4;
+  static constexpr uint64_t never           = UINT64_MAX;
+
+  /**
+   * @brief Intrusive list node embedded in each timer
+   */
+  struct Node
+  {
+    Node*    prev   = nullptr;
+    Node*    next   = nullptr;
+    uint64_t expiry = 0;
+    uint16_t bucket = unlinked;
+  };
+
+private:
+  struct List
+  {
+    Node* head = nullptr;
+    Node* tail = nullptr;
+  };
+
+  static constexpr uint16_t wheel_buckets = levels * slots_per_level;
+  static constexpr uint16_t due_bucket    = wheel_buckets;
+  static constexpr uint16_t overflow      = wheel_buckets + 1;
+  static constexpr uint16_t fired_bucket  = wheel_buckets + 2;
+  static constexpr uint16_t unlinked      = UINT16_MAX;
+  static constexpr uint64_t slot_mask     = slots_per_level - 1;
+
+  List     buckets[wheel_buckets + 3];
+  uint64_t occupied[levels] = {};
+  uint64_t current;
+  size_t   count = 0;
+
+  void link(Node& node, uint16_t bucket)
+  {
+    List& list  = buckets[bucket];
+    node.bucket = bucket;
+    node.next   = nullptr;
+    node.prev   = list.tail;
+    if (list.tail)
+    {
+      list.tail->next = &node;
+    }
+    else
+    {
+      list.head = &node;
+    }
+    list.tail = &node;
+
+    if (bucket < wheel_buckets)
+    {
+      occupied[bucket / slots_per_level] |= uint64_t(1) << (bucket % slots_per_level);
+    }
+  }
+
+  void unlink(Node& node)
+  {
+    List& list = buckets[node.bucket];
+    (node.prev ? node.prev->next : list.head) = node.next;
+    (node.next ? node.next->prev : list.tail) = node.prev;
+
+    if (node.bucket < wheel_buckets && !list.head)
+    {
+      occupied[node.bucket / slots_per_level] &= ~(uint64_t(1) << (node.bucket % slots_per_level));
+    }
+    node.prev   = nullptr;
+    node.next   = nullptr;
+    node.bucket = unlinked;
+  }
+
+  /**
+   * @brief Links a node into the bucket matching its expiry relative to the current tick
+   */
+  void place(Node& node)
+  {
+    if (node.expiry <= current)
+    {
+      link(node, due_bucket);
+      return;
+    }
+
+    // The highest base-64 digit in which expiry and current differ selects the level
+    uint64_t const diff  = node.expiry ^ current;
+    unsigned const level = (std::bit_width(diff) - 1) / level_bits;
+    if (level >= levels)
+    {
+      link(node, overflow);
+      return;
+    }
+    uint64_t const slot = (node.expiry >> (level * level_bits)) & slot_mask;
+    link(node, static_cast<uint16_t>(level * slots_per_level + slot));
+  }
+
+  /**
+   * @brief Re-places every node of a bucket relative to the current tick
+   */
+  void redistribute(uint16_t bucket)
+  {
+    // Detach first: overflow nodes that are still out of range go back to the same bucket
+    Node* node           = buckets[bucket].head;
+    buckets[bucket].head = nullptr;
+    buckets[bucket].tail = nullptr;
+    if (bucket < wheel_buckets)
+    {
+      occupied[bucket / slots_per_level] &= ~(uint64_t(1) << (bucket % slots_per_level));
+    }
+    while (node)
+    {
+      Node* next = node->next;
+      place(*node);
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Moves every node of a bucket to the end of the fired list
+   */
+  void fire(uint16_t bucket)
+  {
+    Node* node = buckets[bucket].head;
+    while (node)
+    {
+      Node* next = node->next;
+      unlink(*node);
+      link(*node, fired_bucket);
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Gets the next tick at which a wheel slot expires or cascades
+   */
+  uint64_t next_wheel_event() const
+  {
+    for (unsigned level = 0; level < levels; level++)
+    {
+      unsigned const shift = level * level_bits;
+      uint64_t const digit = (current >> shift) & slot_mask;
+      // Occupied slots always lie after the current digit of their level
+      uint64_t const after = digit == slot_mask ? 0 : occupied[level] & (~uint64_t(0) << (digit + 1));
+      if (after)
+      {
+        uint64_t const block = (current >> (shift + level_bits)) << (shift + level_bits);
+        return block | (uint64_t(std::countr_zero(after)) << shift);
+      }
+    }
+    if (buckets[overflow].head)
+    {
+      unsigned const top = levels * level_bits;
+      return ((current >> top) + 1) << top;
+    }
+    return never;
+  }
+
+public:
+  /**
+   * @brief Constructs an empty wheel
+   *
+   * @param now The current tick
+   */
+  explicit TimingWheel(uint64_t now = 0)
+    : current(now)
+  {
+  }
+
+  // Nodes point into the wheel, so it must stay in place
+  TimingWheel(const TimingWheel&)            = delete;
+  TimingWheel& operator=(const TimingWheel&) = delete;
+
+  /**
+   * @brief Schedules a node to expire at the given tick
+   *
+   * Nodes whose expiry has already passed expire on the next advance.
+   *
+   * @param node A node that is not currently scheduled
+   * @param expiry The tick at which the node expires
+   */
+  void insert(Node& node, uint64_t expiry)
+  {
+    node.expiry = expiry;
+    place(node);
+    count++;
+  }
+
+  /**
+   * @brief Cancels a scheduled node
+   *
+   * @param node A node that is currently scheduled on this wheel
+   */
+  void remove(Node& node)
+  {
+    unlink(node);
+    count--;
+  }
+
+  /**
+   * @brief Checks whether a node is scheduled
+   */
+  static bool is_scheduled(const Node& node) { return node.bucket != unlinked; }
+
+  /**
+   * @brief Gets the number of scheduled nodes
+   */
+  size_t size() const { return count; }
+
+  /**
+   * @brief Gets the tick the wheel has advanced to
+   */
+  uint64_t get_current_tick() const { return current; }
+
+  /**
+   * @brief Gets the earliest tick at which the wheel has work to do
+   *
+   * This is exact for timers in the lowest level and a lower bound for the
+   * others, whose cascade has to run first.
+   *
+   * @return The tick of the next event, or never if the wheel is empty
+   */
+  uint64_t next_event_tick() const
+  {
+    if (buckets[due_bucket].head || buckets[fired_bucket].head)
+    {
+      return current;
+    }
+    return next_wheel_event();
+  }
+
+  /**
+   * @brief Advances the wheel and expires every node due up to the given tick
+   *
+   * Expired nodes are unscheduled before on_expired is called, in expiry
+   * order, so the callback may reschedule them; nodes rescheduled at or
+   * before the target tick expire on the next advance.
+   *
+   * @param to The tick to advance to
+   * @param on_expired Called with each expired node
+   */
+  template<typename F>
+  void advance(uint64_t to, F&& on_expired)
+  {
+    fire(due_bucket);
+
+    uint64_t next;
+    while ((next = next_wheel_event()) <= to)
+    {
+      current = next;
+
+      // Cascade every level whose block starts now, from the top down
+      if ((current & ((uint64_t(1) << (levels * level_bits)) - 1)) == 0)
+      {
+        redistribute(overflow);
+      }
+      for (unsigned level = levels - 1; level > 0; level--)
+      {
+        unsigned const shift = level * level_bits;
+        if ((current & ((uint64_t(1) << shift) - 1)) == 0)
+        {
+          redistribute(static_cast<uint16_t>(level * slots_per_level + ((current >> shift) & slot_mask)));
+        }
+      }
+      fire(static_cast<uint16_t>(current & slot_mask));
+      fire(due_bucket);
+    }
+    if (to > current)
+    {
+      current = to;
+    }
+
+    while (Node* node = buckets[fired_bucket].head)
+    {
+      remove(*node);
+      on_expired(*node);
+    }
+  }
+};
+
+/**
+ * @brief Async context whose at-time workers are kept in a TimingWheel
+ *
+ * A drop-in alternative to async_context_poll_t for large numbers of timers
+ * with mixed periods: adding, removing and expiring a worker are O(1)
+ * instead of walking a sorted list. Workers are rounded up to the next tick,
+ * so they never run early. Pass get_native_context() to TaskRunner to use it
+ * as the scheduler backend.
+ *
+ * @tparam Capacity The maximum number of workers scheduled at the same time
+ * @tparam TickUs The wheel resolution in microseconds
+ */
+template<size_t Capacity, uint32_t TickUs = 1000>
+class TimingWheelContext
+{
+private:
+  struct Timer : TimingWheel::Node
+  {
+    async_at_time_worker_t* worker = nullptr;
+  };
+
+  /**
+   * @brief The SDK context with a pointer back to its owner
+   *
+   * SDK callbacks only receive the async_context_t. As the first member of a
+   * standard-layout struct it shares the struct's address, so the owner can be
+   * recovered without relying on the layout of TimingWheelContext itself.
+   */
+  struct NativeContext
+  {
+    async_context_t     core;
+    TimingWheelContext* owner;
+  };
+  static_assert(std::is_standard_layout_v<NativeContext>, "the context must be convertible to its wrapper");
+
+  NativeContext native;
+  TimingWheel   wheel;
+  Timer         timers[Capacity];
+  Timer*        free_timers = nullptr;
+  // When-pending workers, linked through their SDK-private next pointer
+  async_when_pending_worker_t* when_pending_list = nullptr;
+
+  static TimingWheelContext* self(async_context_t* context) { return reinterpret_cast<NativeContext*>(context)->owner; }
+
+  /**
+   * @brief Gets the timer holding a worker, or nullptr if the worker is not scheduled here
+   *
+   * While scheduled, a worker's SDK-private next pointer refers to its timer.
+   */
+  Timer* find_timer(async_at_time_worker_t* worker)
+  {
+    auto const address = reinterpret_cast<uintptr_t>(worker->next);
+    auto const first   = reinterpret_cast<uintptr_t>(&timers[0]);
+    if (address < first || address >= first + sizeof(timers) || (address - first) % sizeof(Timer) != 0)
+    {
+      return nullptr;
+    }
+    Timer* timer = reinterpret_cast<Timer*>(worker->next);
+    return timer->worker == worker ? timer : nullptr;
+  }
+
+  void release(Timer& timer)
+  {
+    timer.worker->next = nullptr;
+    timer.worker       = nullptr;
+    timer.next         = free_timers;
+    free_timers        = &timer;
+  }
+
+  void refresh_next_time()
+  {
+    uint64_t const tick   = wheel.next_event_tick();
+    native.core.next_time = tick >= to_us_since_boot(at_the_end_of_time) / TickUs ? at_the_end_of_time : tick * TickUs;
+  }
+
+  static uint64_t current_tick() { return to_us_since_boot(get_absolute_time()) / TickUs; }
+
+  static bool add_at_time_worker(async_context_t* context, async_at_time_worker_t* worker)
+  {
+    TimingWheelContext* ctx = self(context);
+    if (ctx->find_timer(worker) || !ctx->free_timers)
+    {
+      return false;
+    }
+    Timer* timer       = ctx->free_timers;
+    ctx->free_timers   = static_cast<Timer*>(timer->next);
+    timer->worker      = worker;
+    worker->next       = reinterpret_cast<async_at_time_worker_t*>(timer);
+    uint64_t const due = to_us_since_boot(worker->next_time);
+    ctx->wheel.insert(*timer, due / TickUs + (due % TickUs != 0));
+    ctx->refresh_next_time();
+    return true;
+  }
+
+  static bool remove_at_time_worker(async_context_t* context, async_at_time_worker_t* worker)
+  {
+    TimingWheelContext* ctx   = self(context);
+    Timer*              timer = ctx->find_timer(worker);
+    if (!timer)
+    {
+      return false;
+    }
+    ctx->wheel.remove(*timer);
+    ctx->release(*timer);
+    ctx->refresh_next_time();
+    return true;
+  }
+
+  bool has_pending_work() const
+  {
+    for (async_when_pending_worker_t* worker = when_pending_list; worker; worker = worker->next)
+    {
+      if (worker->work_pending)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool add_when_pending_worker(async_context_t* context, async_when_pending_worker_t* worker)
+  {
+    TimingWheelContext* ctx = self(context);
+    for (async_when_pending_worker_t* other = ctx->when_pending_list; other; other = other->next)
+    {
+      if (other == worker)
+      {
+        return false;
+      }
+    }
+    worker->next           = ctx->when_pending_list;
+    ctx->when_pending_list = worker;
+    return true;
+  }
+
+  static bool remove_when_pending_worker(async_context_t* context, async_when_pending_worker_t* worker)
+  {
+    for (async_when_pending_worker_t** link = &self(context)->when_pending_list; *link; link = &(*link)->next)
+    {
+      if (*link == worker)
+      {
+        *link        = worker->next;
+        worker->next = nullptr;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void set_work_pending(async_context_t*, async_when_pending_worker_t* worker)
+  {
+    // Safe from an ISR or the other core: publish the work, then wake a sleeping poll loop
+    worker->work_pending = true;
+    __sev();
+  }
+
+  static void poll(async_context_t* context)
+  {
+    TimingWheelContext* ctx = self(context);
+    ctx->wheel.advance(current_tick(),
+                       [ctx](TimingWheel::Node& node)
+                       {
+                         async_at_time_worker_t* worker = static_cast<Timer&>(node).worker;
+                         ctx->release(static_cast<Timer&>(node));
+                         ctx->refresh_next_time();
+                         worker->do_work(&ctx->native.core, worker);
+                       });
+    ctx->refresh_next_time();
+
+    for (async_when_pending_worker_t* worker = ctx->when_pending_list; worker;)
+    {
+      // do_work may remove the worker
+      async_when_pending_worker_t* next = worker->next;
+      if (worker->work_pending)
+      {
+        worker->work_pending = false;
+        worker->do_work(&ctx->native.core, worker);
+      }
+      worker = next;
+    }
+  }
+
+  static void wait_for_work_until(async_context_t* context, absolute_time_t until)
+  {
+    absolute_time_t const wake = absolute_time_min(context->next_time, until);
+    while (!self(context)->has_pending_work() && !best_effort_wfe_or_timeout(wake))
+    {
+    }
+  }
+
+  static void     wait_until(async_context_t*, absolute_time_t until) { sleep_until(until); }
+  static void     acquire_lock_blocking(async_context_t*) {}
+  static void     release_lock(async_context_t*) {}
+  static void     lock_check(async_context_t*) {}
+  static uint32_t execute_sync(async_context_t*, uint32_t (*func)(void* param), void* param) { return func(param); }
+  static void     deinit(async_context_t*) {}
+
+  static constexpr async_context_type_t type = {
+    .type                       = 0x100,
+    .acquire_lock_blocking      = acquire_lock_blocking,
+    .release_lock               = release_lock,
+    .lock_check                 = lock_check,
+    .execute_sync               = execute_sync,
+    .add_at_time_worker         = add_at_time_worker,
+    .remove_at_time_worker      = remove_at_time_worker,
+    .add_when_pending_worker    = add_when_pending_worker,
+    .remove_when_pending_worker = remove_when_pending_worker,
+    .set_work_pending           = set_work_pending,
+    .poll                       = poll,
+    .wait_until                 = wait_until,
+    .wait_for_work_until        = wait_for_work_until,
+    .deinit                     = deinit,
+  };
+
+public:
+  /**
+   * @brief Constructs an empty context starting at the current time
+   */
+  TimingWheelContext()
+    : native{ {}, this }
+    , wheel(current_tick())
+  {
+    native.core.type      = &type;
+    native.core.next_time = at_the_end_of_time;
+    for (Timer& timer : timers)
+    {
+      timer.next  = free_timers;
+      free_timers = &timer;
+    }
+  }
+
+  // Workers point into the context, so it must stay in place
+  TimingWheelContext(const TimingWheelContext&)            = delete;
+  TimingWheelContext& operator=(const TimingWheelContext&) = delete;
+
+  /**
+   * @brief Gets the SDK async context backed by this wheel
+   *
+   * @return Reference to the async_context_t
+   */
+  async_context_t& get_native_context() { return native.core; }
+
+  /**
+   * @brief Gets the number of workers currently scheduled
+   */
+  size_t size() const { return wheel.size(); }
+};
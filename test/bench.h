@@ -0,0 +1,107 @@
+#pragma once
+
+// Minimal benchmark harness for mameTask-pico
+//
+// Each benchmark is registered with the BENCH macro and reports results as
+// one JSON object per line on stdout, so runs can be diffed and tracked
+// between releases:
+//
+//   {"benchmark":"timer_queue/reschedule","n":1000,"iterations":...,"ns_per_op":...}
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "platform.h"
+
+#ifdef PLATFORM_HOST
+#include <chrono>
+#endif
+
+namespace bench {
+    // Monotonic time in nanoseconds
+    inline uint64_t now_ns() {
+#ifdef PLATFORM_HOST
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+        return ::time_us_64() * 1000;
+#endif
+    }
+
+    // Prevent the compiler from optimizing away a computed value
+    template<typename T>
+    inline void do_not_optimize(T const& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Print one result line
+    inline void report(const char* name, const char* param, uint64_t value,
+                       uint64_t iterations, uint64_t elapsed_ns) {
+        const double ns_per_op = iterations ? double(elapsed_ns) / double(iterations) : 0.0;
+        printf("{\"benchmark\":\"%s\",\"%s\":%" PRIu64 ",\"iterations\":%" PRIu64 ",\"ns_per_op\":%.2f}\n",
+               name, param, value, iterations, ns_per_op);
+    }
+
+    // Print one result line for a benchmark without a parameter
+    inline void report(const char* name, uint64_t iterations, uint64_t elapsed_ns) {
+        const double ns_per_op = iterations ? double(elapsed_ns) / double(iterations) : 0.0;
+        printf("{\"benchmark\":\"%s\",\"iterations\":%" PRIu64 ",\"ns_per_op\":%.2f}\n",
+               name, iterations, ns_per_op);
+    }
+
+    // Print an arbitrary named value, e.g. a size or a ratio
+    inline void report_value(const char* name, const char* key, double value) {
+        printf("{\"benchmark\":\"%s\",\"%s\":%.2f}\n", name, key, value);
+    }
+
+    // Print a named value measured for one parameter value
+    inline void report_value(const char* name, const char* param, uint64_t param_value,
+                             const char* key, double value) {
+        printf("{\"benchmark\":\"%s\",\"%s\":%" PRIu64 ",\"%s\":%.4f}\n",
+               name, param, param_value, key, value);
+    }
+
+    struct Entry {
+        const char* name;
+        void (*run)();
+        Entry* next;
+    };
+
+    inline Entry*& registry() {
+        static Entry* head = nullptr;
+        return head;
+    }
+
+    struct Registrar {
+        Entry entry;
+        Registrar(const char* name, void (*run)()) : entry{name, run, nullptr} {
+            // Append to keep registration order stable within a translation unit
+            Entry** tail = &registry();
+            while (*tail) {
+                tail = &(*tail)->next;
+            }
+            *tail = &entry;
+        }
+    };
+
+    // Run every registered benchmark whose name contains filter (all if null)
+    inline int run_all(const char* filter) {
+        for (Entry* entry = registry(); entry; entry = entry->next) {
+            if (!filter || strstr(entry->name, filter)) {
+                entry->run();
+            }
+        }
+        return 0;
+    }
+}
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+// Define and register a benchmark function
+#define BENCH(NAME)                                                                  \
+    static void BENCH_CONCAT(bench_, NAME)();                                        \
+    static bench::Registrar BENCH_CONCAT(bench_registrar_, NAME)(#NAME, &BENCH_CONCAT(bench_, NAME)); \
+    static void BENCH_CONCAT(bench_, NAME)()
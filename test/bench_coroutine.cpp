@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "../src/mameTaskCoroutine.hpp"
+
+// Coroutine tasks against an equivalent hand-written state machine; both use only the SDK API
+
+static volatile uint32_t g_steps = 0;
+
+static void step() {
+    g_steps = g_steps + 1;
+}
+
+// Three steps separated by a poll each, forever
+static CoroutineTask three_step_sequence() {
+    while (true) {
+        step();
+        co_await next_tick();
+        step();
+        co_await next_tick();
+        step();
+        co_await next_tick();
+    }
+}
+
+// The same sequence as a state machine in a task that is due on every poll
+struct ThreeStepMachine {
+    int state = 0;
+
+    void operator()() {
+        switch (state) {
+        case 0:
+            step();
+            state = 1;
+            break;
+        case 1:
+            step();
+            state = 2;
+            break;
+        default:
+            step();
+            state = 0;
+            break;
+        }
+    }
+};
+
+BENCH(coroutine_step) {
+    const uint64_t iterations = 1000000;
+    {
+        TaskRunner runner(three_step_sequence());
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            runner.poll();
+        }
+        bench::report("coroutine/step", iterations, bench::now_ns() - start);
+    }
+    {
+        TaskRunner runner(create_scheduled_task(0u, ThreeStepMachine{}));
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            runner.poll();
+        }
+        bench::report("coroutine/state_machine_step", iterations, bench::now_ns() - start);
+    }
+}
+
+// Static RAM reserved for the frames of CoroutineTask
+BENCH(coroutine_footprint) {
+    bench::report_value("coroutine/arena", "bytes", CoroutineTask::Arena::storage_bytes);
+}
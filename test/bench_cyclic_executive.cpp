@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "../src/mameTaskCyclicExecutive.hpp"
+#include <memory>
+
+// Cyclic executive benchmarks against the same tasks on TaskRunner; these only use the SDK API and run on host and device
+
+static volatile uint32_t g_calls = 0;
+
+static void count_call() {
+    g_calls = g_calls + 1;
+}
+
+template<uint64_t PeriodUs, size_t>
+using CountingTask = FixedPeriodTask<PeriodUs, void (*)()>;
+
+// Polling when no frame or task is due
+template<size_t... I>
+static void bench_idle(std::index_sequence<I...>) {
+    constexpr uint64_t iterations = 1000000;
+    constexpr uint64_t hour_us = 3600ull * 1000000;
+
+    auto runner = std::make_unique<TaskRunner<CountingTask<hour_us, I>...>>(CountingTask<hour_us, I>(&count_call)...);
+    runner->poll();
+    uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        runner->poll();
+    }
+    bench::report("cyclic/poll_idle_runner", "n", sizeof...(I), iterations, bench::now_ns() - start);
+
+    auto executive = std::make_unique<CyclicExecutive<CountingTask<hour_us, I>...>>(CountingTask<hour_us, I>(&count_call)...);
+    executive->poll();
+    start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        executive->poll();
+    }
+    bench::report("cyclic/poll_idle_executive", "n", sizeof...(I), iterations, bench::now_ns() - start);
+}
+
+// Dispatching n tasks that are all due on every poll, per task
+template<size_t... I>
+static void bench_due(std::index_sequence<I...>) {
+    constexpr uint64_t n = sizeof...(I);
+    const uint64_t polls = 1000000 / n;
+
+    auto runner = std::make_unique<TaskRunner<CountingTask<0, I>...>>(CountingTask<0, I>(&count_call)...);
+    uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < polls; i++) {
+        runner->poll();
+    }
+    bench::report("cyclic/dispatch_runner", "n", n, polls * n, bench::now_ns() - start);
+
+    // Every task in every frame; tick() runs one frame regardless of the time
+    auto executive = std::make_unique<CyclicExecutive<CountingTask<1000, I>...>>(CountingTask<1000, I>(&count_call)...);
+    start = bench::now_ns();
+    for (uint64_t i = 0; i < polls; i++) {
+        executive->tick();
+    }
+    bench::report("cyclic/dispatch_executive", "n", n, polls * n, bench::now_ns() - start);
+}
+
+BENCH(cyclic_poll_idle) {
+    bench_idle(std::make_index_sequence<1>{});
+    bench_idle(std::make_index_sequence<8>{});
+    bench_idle(std::make_index_sequence<32>{});
+}
+
+BENCH(cyclic_dispatch) {
+    bench_due(std::make_index_sequence<1>{});
+    bench_due(std::make_index_sequence<8>{});
+    bench_due(std::make_index_sequence<32>{});
+}
+
+// Flash taken by the schedule table of a 1, 2, 5, 10, 20, 50 and 100ms task set
+BENCH(cyclic_table_size) {
+    using Executive = CyclicExecutive<CountingTask<1000, 0>, CountingTask<2000, 1>, CountingTask<5000, 2>,
+                                      CountingTask<10000, 3>, CountingTask<20000, 4>, CountingTask<50000, 5>,
+                                      CountingTask<100000, 6>>;
+    bench::report_value("cyclic/table_size", "bytes", sizeof(Executive::schedule));
+}
@@ -0,0 +1,156 @@
+#include "bench.h"
+#include "../src/mameTaskPico.hpp"
+#include <array>
+#include <cmath>
+
+// Deadline miss rates of FIFO, fixed-priority and EDF dispatch on synthetic task sets,
+// and the per-poll load peaks with and without phase staggering
+
+#ifdef PLATFORM_HOST
+
+namespace {
+    constexpr size_t set_size = 5;
+    constexpr int sets_per_level = 20;
+    constexpr uint64_t simulated_us = 2000000;
+
+    // Busy-waits for the task's worst-case execution time and counts the run
+    struct Load {
+        const uint32_t* wcet_us;
+        uint32_t* runs;
+
+        void operator()() {
+            busy_wait_us(*wcet_us);
+            (*runs)++;
+        }
+    };
+
+    struct TaskSpec {
+        uint32_t period_us;
+        uint32_t deadline_us;
+        uint32_t wcet_us;
+        uint8_t priority;
+    };
+
+    uint64_t next_random(uint64_t& state) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    // UUniFast utilizations, short periods as in a control loop, and deadlines between 0.5 and 1 period
+    std::array<TaskSpec, set_size> make_task_set(double utilization, uint64_t& seed) {
+        static const uint32_t periods_ms[] = {1, 2, 2, 4, 4, 5, 5, 10};
+        std::array<TaskSpec, set_size> specs{};
+        double remaining = utilization;
+        for (size_t i = 0; i < set_size; i++) {
+            double share = remaining;
+            if (i + 1 < set_size) {
+                const double r = double(next_random(seed) % 1000000) / 1000000.0;
+                const double next = remaining * std::pow(r, 1.0 / double(set_size - 1 - i));
+                share = remaining - next;
+                remaining = next;
+            }
+            specs[i].period_us = periods_ms[next_random(seed) % 8] * 1000;
+            specs[i].deadline_us = specs[i].period_us / 2 + uint32_t(next_random(seed) % (specs[i].period_us / 2 + 1));
+            specs[i].wcet_us = uint32_t(share * specs[i].period_us);
+        }
+        // Deadline-monotonic priorities for the fixed-priority mode
+        for (size_t i = 0; i < set_size; i++) {
+            uint8_t rank = 0;
+            for (size_t j = 0; j < set_size; j++) {
+                rank += specs[j].deadline_us > specs[i].deadline_us ||
+                        (specs[j].deadline_us == specs[i].deadline_us && j > i);
+            }
+            specs[i].priority = rank;
+        }
+        return specs;
+    }
+
+    template<size_t... I>
+    void simulate(const std::array<TaskSpec, set_size>& specs, DispatchMode mode,
+                  uint64_t& jobs, uint64_t& misses, std::index_sequence<I...>) {
+        VirtualClock clock;
+        std::array<uint32_t, set_size> runs{};
+        auto make = [&](size_t i) {
+            auto task = ScheduledTask<Load>(std::chrono::microseconds{specs[i].period_us},
+                                            Load{&specs[i].wcet_us, &runs[i]},
+                                            SchedulePolicy::burst, specs[i].priority);
+            task.set_relative_deadline(std::chrono::microseconds{specs[i].deadline_us});
+            return task;
+        };
+        TaskRunner runner(make(I)...);
+        runner.set_dispatch_mode(mode);
+        runner.set_deadline_tracking(true);
+
+        const absolute_time_t end = delayed_by_us(clock.now(), simulated_us);
+        while (clock.now() < end) {
+            runner.poll();
+            runner.wait_for_work_until(end);
+        }
+        ((jobs += runs[I], misses += runner.template get_task<I>().get_deadline_misses()), ...);
+    }
+}
+
+BENCH(dispatch_deadline_misses) {
+    static const uint64_t utilization_percent[] = {50, 70, 80, 90, 95};
+    static const struct {
+        DispatchMode mode;
+        const char* name;
+    } modes[] = {
+        {DispatchMode::fifo, "deadline_misses/fifo"},
+        {DispatchMode::priority, "deadline_misses/deadline_monotonic"},
+        {DispatchMode::edf, "deadline_misses/edf"},
+    };
+
+    for (uint64_t percent : utilization_percent) {
+        for (const auto& mode : modes) {
+            uint64_t seed = percent;
+            uint64_t jobs = 0;
+            uint64_t misses = 0;
+            for (int set = 0; set < sets_per_level; set++) {
+                const auto specs = make_task_set(double(percent) / 100.0, seed);
+                simulate(specs, mode.mode, jobs, misses, std::make_index_sequence<set_size>{});
+            }
+            bench::report_value(mode.name, "utilization_percent", percent, "miss_rate",
+                                jobs ? double(misses) / double(jobs) : 0.0);
+        }
+    }
+}
+
+namespace {
+    // Typical firmware periods in ms; each run takes 200us
+    constexpr std::array<unsigned, 12> stagger_periods_ms = {10, 20, 25, 50, 100, 100, 200, 250, 500, 500, 1000, 1000};
+    constexpr uint32_t stagger_wcet_us = 200;
+
+    // Runs the set for 10 simulated seconds and reports the largest number of runs and busy time in one poll
+    template<size_t... I>
+    void simulate_peaks(bool staggered, const char* name, std::index_sequence<I...>) {
+        VirtualClock clock;
+        uint32_t runs = 0;
+        const uint32_t wcet_us = stagger_wcet_us;
+        TaskRunner runner(task_descriptor(stagger_periods_ms[I], Load{&wcet_us, &runs}, SchedulePolicy::skip)...);
+        if (staggered) {
+            runner.stagger();
+        }
+
+        uint32_t peak_runs = 0;
+        uint64_t peak_busy_us = 0;
+        const absolute_time_t end = delayed_by_us(clock.now(), 10000000);
+        while (clock.now() < end) {
+            const uint32_t before = runs;
+            const uint64_t started = clock.now();
+            runner.poll();
+            peak_runs = runs - before > peak_runs ? runs - before : peak_runs;
+            peak_busy_us = clock.now() - started > peak_busy_us ? clock.now() - started : peak_busy_us;
+            runner.wait_for_work_until(end);
+        }
+        bench::report_value(name, "peak_runs_per_poll", peak_runs);
+        bench::report_value(name, "peak_busy_us", double(peak_busy_us));
+    }
+}
+
+BENCH(dispatch_stagger) {
+    simulate_peaks(false, "stagger/unstaggered", std::make_index_sequence<stagger_periods_ms.size()>{});
+    simulate_peaks(true, "stagger/staggered", std::make_index_sequence<stagger_periods_ms.size()>{});
+}
+
+#endif
@@ -0,0 +1,17 @@
+// Include the benchmark harness
+#include "bench.h"
+
+// Define the main function
+int main(int argc, const char* const argv[]) {
+    // Initialize platform-specific resources
+    test_platform::init();
+
+    // Optional first argument selects benchmarks by substring
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int result = bench::run_all(filter);
+
+    // Clean up platform-specific resources
+    test_platform::cleanup();
+
+    return result;
+}
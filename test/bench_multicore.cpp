@@ -0,0 +1,133 @@
+#include "bench.h"
+#include "../src/mameTaskMulticore.hpp"
+#include <atomic>
+
+// Job throughput of one runner against a runner on each core, with and without work stealing; host only
+
+#ifdef PLATFORM_HOST
+#include <thread>
+
+static constexpr uint32_t jobs = 20000;
+
+// Roughly a few microseconds of computation per job
+static uint64_t busy_work(uint32_t seed) {
+    uint64_t state = seed;
+    for (int i = 0; i < 2000; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return state;
+}
+
+using Runner = TaskRunner<CoreMailbox<256>>;
+
+// Posts a job to a mailbox, polling core 0 while the mailbox is full
+template<typename Post>
+static void post_job(Runner& core0, Post&& post) {
+    while (!post()) {
+        core0.poll();
+    }
+}
+
+// All jobs go through core 0's mailbox; returns jobs per second
+static double one_runner() {
+    Runner core0(CoreMailbox<256>{});
+    std::atomic<uint32_t> done{0};
+    auto* const counter = &done;
+    const uint64_t start = bench::now_ns();
+    for (uint32_t i = 0; i < jobs; i++) {
+        post_job(core0, [&]() {
+            return core0.get_task<0>().post([counter, i]() {
+                bench::do_not_optimize(busy_work(i));
+                counter->fetch_add(1, std::memory_order_relaxed);
+            });
+        });
+    }
+    while (done.load(std::memory_order_relaxed) < jobs) {
+        core0.poll();
+    }
+    return double(jobs) * 1e9 / double(bench::now_ns() - start);
+}
+
+// Jobs alternate between the two cores' mailboxes; returns jobs per second
+static double two_runners() {
+    Runner core0(CoreMailbox<256>{});
+    Runner core1(CoreMailbox<256>{});
+    DualCoreRunner cores(core0, core1);
+    cores.launch_core1();
+    std::atomic<uint32_t> done{0};
+    auto* const counter = &done;
+    const uint64_t start = bench::now_ns();
+    for (uint32_t i = 0; i < jobs; i++) {
+        auto job = [counter, i]() {
+            bench::do_not_optimize(busy_work(i));
+            counter->fetch_add(1, std::memory_order_relaxed);
+        };
+        if (i & 1) {
+            post_job(core0, [&]() { return cores.post<1>(job); });
+        } else {
+            post_job(core0, [&]() { return cores.post<0>(job); });
+        }
+    }
+    while (done.load(std::memory_order_relaxed) < jobs) {
+        core0.poll();
+        // Leaves the core to core 1 when they share a hardware thread
+        std::this_thread::yield();
+    }
+    const double throughput = double(jobs) * 1e9 / double(bench::now_ns() - start);
+    cores.stop_core1();
+    return throughput;
+}
+
+using StealingRunner = TaskRunner<CoreMailbox<>, JobDeque<256>>;
+
+// Pushes the jobs to core 0's deque, polling when it is full, and runs core 0 until they are done;
+// returns jobs per second
+template<typename Push, typename Idle>
+static double burst_throughput(StealingRunner& core0, Push&& push, Idle&& idle) {
+    std::atomic<uint32_t> done{0};
+    auto* const counter = &done;
+    const uint64_t start = bench::now_ns();
+    for (uint32_t i = 0; i < jobs; i++) {
+        auto job = [counter, i]() {
+            bench::do_not_optimize(busy_work(i));
+            counter->fetch_add(1, std::memory_order_relaxed);
+        };
+        while (!push(job)) {
+            core0.poll();
+        }
+    }
+    while (done.load(std::memory_order_relaxed) < jobs) {
+        core0.poll();
+        idle();
+    }
+    return double(jobs) * 1e9 / double(bench::now_ns() - start);
+}
+
+BENCH(multicore_job_throughput) {
+    // The emulated cores only run in parallel with enough hardware threads
+    bench::report_value("multicore/hardware_threads", "threads", std::thread::hardware_concurrency());
+    const double single = one_runner();
+    const double dual = two_runners();
+    bench::report_value("multicore/one_runner", "jobs_per_s", single);
+    bench::report_value("multicore/two_runners", "jobs_per_s", dual);
+    bench::report_value("multicore/speedup", "ratio", dual / single);
+}
+
+BENCH(multicore_work_stealing) {
+    StealingRunner alone(CoreMailbox<>{}, JobDeque<256>{});
+    const double single = burst_throughput(alone, [&](auto job) { return alone.get_task<1>().push(job); }, []() {});
+
+    StealingRunner core0(CoreMailbox<>{}, JobDeque<256>{});
+    TaskRunner core1(CoreMailbox<>{});
+    DualCoreRunner cores(core0, core1);
+    cores.launch_core1();
+    const double stealing = burst_throughput(
+        core0, [&](auto job) { return cores.push_job<0>(job); }, []() { std::this_thread::yield(); });
+    cores.stop_core1();
+
+    bench::report_value("multicore/burst_one_runner", "jobs_per_s", single);
+    bench::report_value("multicore/burst_stealing", "jobs_per_s", stealing);
+    bench::report_value("multicore/stealing_speedup", "ratio", stealing / single);
+}
+
+#endif // PLATFORM_HOST
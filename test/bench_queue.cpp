@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "../src/mameTaskQueue.hpp"
+#include <memory>
+
+// Message queue throughput with producer threads; host only
+
+#ifdef PLATFORM_HOST
+#include <thread>
+#include <vector>
+
+static constexpr uint32_t messages = 4000000;
+
+// Pushes messages from producer threads while the consumer pops; returns messages per second
+template<typename Queue, typename Consume>
+static double measure_throughput(Queue& queue, uint32_t producers, Consume&& consume) {
+    const uint32_t per_producer = messages / producers;
+    const uint64_t start = bench::now_ns();
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, per_producer]() {
+            for (uint32_t i = 0; i < per_producer; i++) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    consume(per_producer * producers);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return double(per_producer * producers) * 1e9 / double(bench::now_ns() - start);
+}
+
+// Consumer spinning on pop() without a task
+template<typename Queue>
+static double spinning_consumer(Queue& queue, uint32_t producers) {
+    return measure_throughput(queue, producers, [&queue](uint32_t total) {
+        uint32_t value;
+        for (uint32_t received = 0; received < total;) {
+            if (queue.pop(value)) {
+                received++;
+            } else {
+                // Leaves the core to the producers when they share it
+                std::this_thread::yield();
+            }
+        }
+    });
+}
+
+// Consumer event task woken by each push, on a tickless runner loop
+template<typename Queue>
+static double task_consumer(Queue& queue, uint32_t producers) {
+    uint32_t received = 0;
+    TaskRunner runner(create_event_task([&]() {
+        received += queue.drain([](uint32_t value) { bench::do_not_optimize(value); });
+    }));
+    queue.set_consumer(runner.template get_task<0>());
+    return measure_throughput(queue, producers, [&](uint32_t total) {
+        while (received < total) {
+            runner.wait_for_work_until(at_the_end_of_time);
+            runner.poll();
+        }
+    });
+}
+
+BENCH(queue_spsc_throughput) {
+    // Producer and consumer threads only run in parallel with enough hardware threads
+    bench::report_value("queue/hardware_threads", "threads", std::thread::hardware_concurrency());
+    auto spinning = std::make_unique<SpscQueue<uint32_t, 1024>>();
+    bench::report_value("queue/spsc_spinning", "producers", 1, "msgs_per_s", spinning_consumer(*spinning, 1));
+    auto signalled = std::make_unique<SpscQueue<uint32_t, 1024>>();
+    bench::report_value("queue/spsc_event_task", "producers", 1, "msgs_per_s", task_consumer(*signalled, 1));
+}
+
+BENCH(queue_mpsc_throughput) {
+    for (uint32_t producers : {1u, 2u, 4u}) {
+        auto spinning = std::make_unique<MpscQueue<uint32_t, 1024>>();
+        bench::report_value("queue/mpsc_spinning", "producers", producers, "msgs_per_s",
+                            spinning_consumer(*spinning, producers));
+    }
+    for (uint32_t producers : {1u, 2u, 4u}) {
+        auto signalled = std::make_unique<MpscQueue<uint32_t, 1024>>();
+        bench::report_value("queue/mpsc_event_task", "producers", producers, "msgs_per_s",
+                            task_consumer(*signalled, producers));
+    }
+}
+
+#endif // PLATFORM_HOST
@@ -0,0 +1,177 @@
+#include "bench.h"
+#include "../src/mameTaskPico.hpp"
+#include <vector>
+
+// TaskRunner and ScheduledTask benchmarks; these only use the SDK API and run on host and device
+
+static const uint64_t task_counts[] = {1, 10, 100, 1000};
+
+static volatile uint32_t g_calls = 0;
+
+static void count_call() {
+    g_calls = g_calls + 1;
+}
+
+// Far enough in the future that nothing becomes due while benchmarking
+static absolute_time_t far_future() {
+    return make_timeout_time_us(3600ull * 1000000);
+}
+
+// Reschedules itself so that it is due again on the next poll
+static void reschedule_now(async_context_t* context, async_at_time_worker_t* worker) {
+    count_call();
+    async_context_add_at_time_worker_at(context, worker, 0);
+}
+
+// Polling when no task is due
+BENCH(runner_poll_idle) {
+    auto task = create_scheduled_task(std::chrono::hours{1}, &count_call);
+    TaskRunner runner(std::move(task));
+    runner.poll();
+
+    const uint64_t iterations = 1000000;
+    const uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        runner.poll();
+    }
+    bench::report("runner/poll", "due", 0, iterations, bench::now_ns() - start);
+}
+
+// Polling with a single task that is due on every poll
+BENCH(runner_poll_one_due) {
+    auto task = create_scheduled_task(0u, &count_call);
+    TaskRunner runner(std::move(task));
+
+    const uint64_t iterations = 1000000;
+    const uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        runner.poll();
+    }
+    bench::report("runner/poll", "due", 1, iterations, bench::now_ns() - start);
+}
+
+// Polling with n tasks that are all due on every poll
+BENCH(runner_poll_n_due) {
+    for (uint64_t n : task_counts) {
+        async_context_poll_t context;
+        async_context_poll_init_with_defaults(&context);
+        // Construct in place so that each worker's user_data stays valid
+        std::vector<ScheduledTask<void (*)()>> tasks;
+        tasks.reserve(n);
+        for (uint64_t i = 0; i < n; i++) {
+            tasks.emplace_back(0u, &count_call);
+            async_context_add_at_time_worker_in_ms(&context.core, &tasks.back().get_native_worker(), 0);
+        }
+
+        const uint64_t polls = 100000 / n;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < polls; i++) {
+            async_context_poll(&context.core);
+        }
+        bench::report("runner/poll_n_due", "n", n, polls * n, bench::now_ns() - start);
+    }
+}
+
+// Cost of one dispatch: a raw call, a bare worker and a ScheduledTask
+BENCH(runner_dispatch) {
+    const uint64_t iterations = 1000000;
+
+    void (*volatile raw)() = &count_call;
+    uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        raw();
+    }
+    bench::report("dispatch/raw_call", iterations, bench::now_ns() - start);
+
+    // Same queue work as a ScheduledTask, without the trampoline and policy
+    async_context_poll_t context;
+    async_context_poll_init_with_defaults(&context);
+    async_at_time_worker_t worker = {};
+    worker.do_work = reschedule_now;
+    async_context_add_at_time_worker_at(&context.core, &worker, 0);
+    start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        async_context_poll(&context.core);
+    }
+    bench::report("dispatch/raw_worker", iterations, bench::now_ns() - start);
+    async_context_remove_at_time_worker(&context.core, &worker);
+
+    ScheduledTask<void (*)()> task(0u, &count_call);
+    async_context_add_at_time_worker_in_ms(&context.core, &task.get_native_worker(), 0);
+    start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        async_context_poll(&context.core);
+    }
+    bench::report("dispatch/scheduled_task", iterations, bench::now_ns() - start);
+    async_context_remove_at_time_worker(&context.core, &task.get_native_worker());
+
+    FixedPeriodTask<0, void (*)()> fixed_task(&count_call);
+    async_context_add_at_time_worker_in_ms(&context.core, &fixed_task.get_native_worker(), 0);
+    start = bench::now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        async_context_poll(&context.core);
+    }
+    bench::report("dispatch/fixed_period_task", iterations, bench::now_ns() - start);
+}
+
+template<size_t>
+using RuntimeIntervalTask = ScheduledTask<void (*)()>;
+
+// Runners of 20 tasks with periods of 1..20ms, given at runtime or in the type
+template<size_t... I>
+static void report_twenty_tasks(std::index_sequence<I...>) {
+    using RuntimeRunner = TaskRunner<RuntimeIntervalTask<I>...>;
+    using FixedRunner = TaskRunner<FixedPeriodTask<(I + 1) * 1000, void (*)()>...>;
+    bench::report_value("runner/twenty_tasks", "runtime_interval_bytes", sizeof(RuntimeRunner));
+    bench::report_value("runner/twenty_tasks", "fixed_interval_bytes", sizeof(FixedRunner));
+}
+
+// Footprint of a task, which grows only when statistics are enabled
+BENCH(runner_task_size) {
+    bench::report_value("runner/task_size", "bytes", sizeof(ScheduledTask<void (*)()>));
+    bench::report_value("runner/fixed_period_task_size", "bytes", sizeof(FixedPeriodTask<1000, void (*)()>));
+    report_twenty_tasks(std::make_index_sequence<20>{});
+}
+
+// Rescheduling a due task while n - 1 others wait in the queue
+BENCH(runner_reschedule) {
+    for (uint64_t n : task_counts) {
+        async_context_poll_t context;
+        async_context_poll_init_with_defaults(&context);
+        std::vector<async_at_time_worker_t> idle(n - 1);
+        const absolute_time_t idle_time = far_future();
+        for (auto& worker : idle) {
+            async_context_add_at_time_worker_at(&context.core, &worker, idle_time);
+        }
+        ScheduledTask<void (*)()> task(0u, &count_call);
+        async_context_add_at_time_worker_in_ms(&context.core, &task.get_native_worker(), 0);
+
+        const uint64_t iterations = 200000;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            async_context_poll(&context.core);
+        }
+        bench::report("runner/reschedule", "n", n, iterations, bench::now_ns() - start);
+    }
+}
+
+// Time from a task's deadline until the tickless loop wakes up for it
+BENCH(runner_wake_latency) {
+    constexpr int wakeups = 200;
+    auto task = create_scheduled_task(std::chrono::milliseconds{1}, &count_call, SchedulePolicy::skip);
+    TaskRunner runner(std::move(task));
+    runner.poll();
+
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+    for (int i = 0; i < wakeups; i++) {
+        const absolute_time_t deadline = runner.get_next_deadline();
+        runner.wait_for_work_until(at_the_end_of_time);
+        const uint64_t latency_us = absolute_time_diff_us(deadline, get_absolute_time());
+        total_us += latency_us;
+        max_us = latency_us > max_us ? latency_us : max_us;
+        runner.poll();
+    }
+    bench::report_value("runner/wake_latency", "mean_ns", double(total_us) * 1000.0 / wakeups);
+    bench::report_value("runner/wake_latency", "max_ns", double(max_us) * 1000.0);
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "../src/mameTaskSoftTimer.hpp"
+#include <memory>
+#include <vector>
+
+// Restart-heavy timeout workloads: soft timers against one SDK worker per timeout
+
+#ifdef PLATFORM_HOST
+
+static const uint64_t timer_counts[] = {100, 1000, 10000};
+
+static constexpr std::chrono::microseconds timeout{100000};
+
+// Deterministic pseudo random numbers
+static uint64_t next_random(uint64_t& state) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+}
+
+static volatile uint64_t g_expired = 0;
+
+static void count_expiry(void*) {
+    g_expired = g_expired + 1;
+}
+
+static void count_worker_expiry(async_context_t*, async_at_time_worker_t*) {
+    g_expired = g_expired + 1;
+}
+
+// Restarts random timers, with 1ms of simulated time and a poll after every 64 restarts
+template<typename Restart, typename Poll>
+static uint64_t restart_workload(uint64_t n, Restart&& restart, Poll&& poll) {
+    constexpr uint64_t restarts = 1000000;
+    uint64_t seed = n;
+    const uint64_t start = bench::now_ns();
+    for (uint64_t i = 0; i < restarts; i++) {
+        restart(next_random(seed) % n);
+        if (i % 64 == 63) {
+            busy_wait_us(1000);
+            poll();
+        }
+    }
+    return bench::now_ns() - start;
+}
+
+template<size_t N>
+static void bench_soft_timers() {
+    test_platform::SimulatedTime simulated_time;
+    auto runner = std::make_unique<TaskRunner<SoftTimers<N>>>(SoftTimers<N>{});
+    auto& timers = runner->template get_task<0>();
+    std::vector<SoftTimerHandle> handles(N);
+    for (auto& handle : handles) {
+        handle = timers.create(&count_expiry);
+        timers.restart(handle, timeout);
+    }
+    const uint64_t elapsed = restart_workload(N,
+        [&](uint64_t i) { timers.restart(handles[i], timeout); },
+        [&]() { runner->poll(); });
+    bench::report("soft_timer/restart", "n", N, 1000000, elapsed);
+}
+
+// The same timeouts as one at-time worker each, restarted by removing and re-adding the worker
+static void bench_workers(const char* name, async_context_t* context, uint64_t n) {
+    std::vector<async_at_time_worker_t> workers(n);
+    for (auto& worker : workers) {
+        worker.do_work = count_worker_expiry;
+        async_context_add_at_time_worker_in_ms(context, &worker, timeout.count() / 1000);
+    }
+    const uint64_t elapsed = restart_workload(n,
+        [&](uint64_t i) {
+            async_context_remove_at_time_worker(context, &workers[i]);
+            async_context_add_at_time_worker_in_ms(context, &workers[i], timeout.count() / 1000);
+        },
+        [&]() { async_context_poll(context); });
+    for (auto& worker : workers) {
+        async_context_remove_at_time_worker(context, &worker);
+    }
+    bench::report(name, "n", n, 1000000, elapsed);
+}
+
+BENCH(soft_timer_restart) {
+    bench_soft_timers<100>();
+    bench_soft_timers<1000>();
+    bench_soft_timers<10000>();
+}
+
+BENCH(soft_timer_worker_restart) {
+    for (uint64_t n : timer_counts) {
+        test_platform::SimulatedTime simulated_time;
+        async_context_poll_t poll_context;
+        async_context_poll_init_with_defaults(&poll_context);
+        bench_workers("soft_timer/worker_restart_poll_context", &poll_context.core, n);
+    }
+    for (uint64_t n : timer_counts) {
+        test_platform::SimulatedTime simulated_time;
+        auto wheel = std::make_unique<TimingWheelContext<10000>>();
+        bench_workers("soft_timer/worker_restart_timing_wheel", &wheel->get_native_context(), n);
+    }
+}
+
+#endif // PLATFORM_HOST
@@ -0,0 +1,89 @@
+#include "bench.h"
+#include <vector>
+
+// Scaling benchmarks for the host async_context mock timer queue
+
+#ifdef PLATFORM_HOST
+
+static const uint64_t worker_counts[] = {10, 100, 1000, 10000, 100000};
+
+// Far enough in the future that no worker becomes due while benchmarking
+static const absolute_time_t far_future = at_the_end_of_time / 2;
+
+// Reschedules itself so that it is due again on the next poll
+static void reschedule_in_past(async_context_t* context, async_at_time_worker_t* worker) {
+    async_context_add_at_time_worker_at(context, worker, 0);
+}
+
+// Deterministic pseudo random deadlines in the far future
+static uint64_t next_random(uint64_t& state) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+}
+
+// Inserting and then removing n workers with scattered deadlines
+BENCH(timer_queue_schedule_cancel) {
+    for (uint64_t n : worker_counts) {
+        std::vector<async_at_time_worker_t> workers(n);
+        async_context_poll_t context;
+        async_context_poll_init_with_defaults(&context);
+        uint64_t seed = 1;
+
+        const uint64_t start = bench::now_ns();
+        for (auto& worker : workers) {
+            async_context_add_at_time_worker_at(&context.core, &worker, far_future + next_random(seed));
+        }
+        const uint64_t inserted = bench::now_ns();
+        for (auto& worker : workers) {
+            async_context_remove_at_time_worker(&context.core, &worker);
+        }
+        const uint64_t removed = bench::now_ns();
+
+        bench::report("timer_queue/schedule", "n", n, n, inserted - start);
+        bench::report("timer_queue/cancel", "n", n, n, removed - inserted);
+    }
+}
+
+// One due worker popped and rescheduled per poll while n - 1 wait
+BENCH(timer_queue_poll_one_due) {
+    for (uint64_t n : worker_counts) {
+        std::vector<async_at_time_worker_t> workers(n);
+        async_context_poll_t context;
+        async_context_poll_init_with_defaults(&context);
+        uint64_t seed = 2;
+        for (size_t i = 1; i < workers.size(); i++) {
+            async_context_add_at_time_worker_at(&context.core, &workers[i], far_future + next_random(seed));
+        }
+        workers[0].do_work = reschedule_in_past;
+        async_context_add_at_time_worker_at(&context.core, &workers[0], 0);
+
+        const uint64_t iterations = 100000;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            async_context_poll(&context.core);
+        }
+        bench::report("timer_queue/poll_one_due", "n", n, iterations, bench::now_ns() - start);
+    }
+}
+
+// Every worker popped and rescheduled on each poll
+BENCH(timer_queue_poll_all_due) {
+    for (uint64_t n : worker_counts) {
+        std::vector<async_at_time_worker_t> workers(n);
+        async_context_poll_t context;
+        async_context_poll_init_with_defaults(&context);
+        for (auto& worker : workers) {
+            worker.do_work = reschedule_in_past;
+            async_context_add_at_time_worker_at(&context.core, &worker, 0);
+        }
+
+        const uint64_t polls = n >= 10000 ? 10 : 1000;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < polls; i++) {
+            async_context_poll(&context.core);
+        }
+        bench::report("timer_queue/poll_all_due", "n", n, polls * n, bench::now_ns() - start);
+    }
+}
+
+#endif // PLATFORM_HOST
@@ -0,0 +1,107 @@
+#include "bench.h"
+#include "../src/mameTaskTimingWheel.hpp"
+#include <memory>
+#include <vector>
+
+// Timing wheel benchmarks, comparable with the timer_queue/* results of the mock context
+
+#ifdef PLATFORM_HOST
+
+static const uint64_t worker_counts[] = {10, 100, 1000, 10000, 100000};
+
+using WheelContext = TimingWheelContext<100000>;
+
+// Far enough in the future that no worker becomes due while benchmarking
+static const absolute_time_t far_future = make_timeout_time_us(3600ull * 1000000);
+
+// Reschedules itself so that it is due again on the next poll
+static void reschedule_in_past(async_context_t* context, async_at_time_worker_t* worker) {
+    async_context_add_at_time_worker_at(context, worker, 0);
+}
+
+// Deterministic pseudo random numbers
+static uint64_t next_random(uint64_t& state) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+}
+
+// Inserting and then removing n workers with scattered deadlines
+BENCH(timing_wheel_schedule_cancel) {
+    for (uint64_t n : worker_counts) {
+        std::vector<async_at_time_worker_t> workers(n);
+        auto context = std::make_unique<WheelContext>();
+        async_context_t* core = &context->get_native_context();
+        uint64_t seed = 1;
+
+        const uint64_t start = bench::now_ns();
+        for (auto& worker : workers) {
+            async_context_add_at_time_worker_at(core, &worker, far_future + next_random(seed) % 1000000000);
+        }
+        const uint64_t inserted = bench::now_ns();
+        for (auto& worker : workers) {
+            async_context_remove_at_time_worker(core, &worker);
+        }
+        const uint64_t removed = bench::now_ns();
+
+        bench::report("timing_wheel/schedule", "n", n, n, inserted - start);
+        bench::report("timing_wheel/cancel", "n", n, n, removed - inserted);
+    }
+}
+
+// One due worker popped and rescheduled per poll while n - 1 wait
+BENCH(timing_wheel_poll_one_due) {
+    for (uint64_t n : worker_counts) {
+        std::vector<async_at_time_worker_t> workers(n);
+        auto context = std::make_unique<WheelContext>();
+        async_context_t* core = &context->get_native_context();
+        uint64_t seed = 2;
+        for (size_t i = 1; i < workers.size(); i++) {
+            async_context_add_at_time_worker_at(core, &workers[i], far_future + next_random(seed) % 1000000000);
+        }
+        workers[0].do_work = reschedule_in_past;
+        async_context_add_at_time_worker_at(core, &workers[0], 0);
+
+        const uint64_t iterations = 100000;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            async_context_poll(core);
+        }
+        bench::report("timing_wheel/poll_one_due", "n", n, iterations, bench::now_ns() - start);
+    }
+}
+
+// Periodic timer node for the simulated fleet
+struct FleetTimer : TimingWheel::Node {
+    uint64_t period;
+};
+
+// n periodic timers with periods from 1ms to 2 hours, simulated one 1ms tick at a time
+BENCH(timing_wheel_mixed_periods) {
+    for (uint64_t n : worker_counts) {
+        std::vector<FleetTimer> timers(n);
+        TimingWheel wheel(0);
+        uint64_t seed = 3;
+        for (auto& timer : timers) {
+            // Log-uniform periods so short and long timers are both common
+            timer.period = uint64_t(1) << (next_random(seed) % 23);
+            timer.period += next_random(seed) % timer.period;
+            wheel.insert(timer, timer.period);
+        }
+
+        const uint64_t ticks = n >= 10000 ? 10000 : 100000;
+        uint64_t expired = 0;
+        const uint64_t start = bench::now_ns();
+        for (uint64_t tick = 1; tick <= ticks; tick++) {
+            wheel.advance(tick, [&](TimingWheel::Node& node) {
+                auto& timer = static_cast<FleetTimer&>(node);
+                wheel.insert(timer, timer.expiry + timer.period);
+                expired++;
+            });
+        }
+        const uint64_t elapsed = bench::now_ns() - start;
+        bench::report("timing_wheel/mixed_periods_per_tick", "n", n, ticks, elapsed);
+        bench::report("timing_wheel/mixed_periods_per_expiry", "n", n, expired, elapsed);
+    }
+}
+
+#endif // PLATFORM_HOST
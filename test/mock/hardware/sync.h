@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Mock of the Pico SDK event register (hardware/sync.h)
+//
+// Each thread has its own sticky event flag, like each core has its own event
+// register. __sev() sets the flag of every thread and wakes any thread blocked in
+// __wfe() or best_effort_wfe_or_timeout(); waiting clears only the caller's flag.
+namespace mock_event_register {
+    struct state {
+        std::mutex mutex;
+        std::condition_variable changed;
+        // Number of __sev() calls so far
+        uint64_t events = 0;
+    };
+
+    inline state& get() {
+        static state event_register;
+        return event_register;
+    }
+
+    // Events this thread has already consumed
+    inline uint64_t& consumed() {
+        thread_local uint64_t seen = 0;
+        return seen;
+    }
+
+    // Whether this thread's flag is set; call with the mutex held
+    inline bool is_set(const state& event_register) {
+        return event_register.events != consumed();
+    }
+
+    // Clears this thread's flag; call with the mutex held
+    inline void clear(const state& event_register) {
+        consumed() = event_register.events;
+    }
+}
+
+inline void __sev() {
+    auto& event_register = mock_event_register::get();
+    {
+        std::lock_guard<std::mutex> lock(event_register.mutex);
+        event_register.events++;
+    }
+    event_register.changed.notify_all();
+}
+
+inline void __wfe() {
+    auto& event_register = mock_event_register::get();
+    std::unique_lock<std::mutex> lock(event_register.mutex);
+    event_register.changed.wait(lock, [&]() { return mock_event_register::is_set(event_register); });
+    mock_event_register::clear(event_register);
+}
@@ -1,26 +1,79 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <functional>
 #include <thread>
 #include <chrono>
 #include <vector>
-#include <queue>
 #include <utility>
 #include <algorithm>
+#include <atomic>
 
-// Forward declarations
-inline uint64_t time_us_64();
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+struct async_context_t;
+struct async_at_time_worker_t;
+struct async_when_pending_worker_t;
+
+// Operations of an async context implementation, mirroring the SDK vtable
+struct async_context_type_t {
+    uint16_t type;
+    void (*acquire_lock_blocking)(async_context_t* self);
+    void (*release_lock)(async_context_t* self);
+    void (*lock_check)(async_context_t* self);
+    uint32_t (*execute_sync)(async_context_t* context, uint32_t (*func)(void* param), void* param);
+    bool (*add_at_time_worker)(async_context_t* self, async_at_time_worker_t* worker);
+    bool (*remove_at_time_worker)(async_context_t* self, async_at_time_worker_t* worker);
+    bool (*add_when_pending_worker)(async_context_t* self, async_when_pending_worker_t* worker);
+    bool (*remove_when_pending_worker)(async_context_t* self, async_when_pending_worker_t* worker);
+    void (*set_work_pending)(async_context_t* self, async_when_pending_worker_t* worker);
+    void (*poll)(async_context_t* self);
+    void (*wait_until)(async_context_t* self, absolute_time_t until);
+    void (*wait_for_work_until)(async_context_t* self, absolute_time_t until);
+    void (*deinit)(async_context_t* self);
+};
+
+// Entry of the mock timer queue, ordered by deadline and then by insertion
+struct async_timer_entry_t {
+    uint64_t time_us;
+    uint64_t sequence;
+    async_at_time_worker_t* worker;
+};
 
 // Simplified mock structures to replace Pico SDK dependencies
 struct async_context_t {
-    // Store scheduled workers for timing tests
-    std::vector<std::pair<uint64_t, struct async_at_time_worker_t*>> scheduled_workers;
+    // Implementation; nullptr selects the built-in poll context
+    const async_context_type_t* type = nullptr;
+    // Binary min-heap of scheduled workers keyed by (time_us, sequence)
+    std::vector<async_timer_entry_t> scheduled_workers;
+    uint64_t next_sequence = 0;
+    // Singly linked list of when-pending workers, like the SDK
+    async_when_pending_worker_t* when_pending_list = nullptr;
     uint64_t current_time_us;
+    // Earliest pending deadline, as maintained by the SDK
+    absolute_time_t next_time = at_the_end_of_time;
+    uint16_t flags = 0;
+    uint8_t core_num = 0;
 };
 
 struct async_at_time_worker_t {
+    // Owned by the context the worker is scheduled on
+    async_at_time_worker_t* next;
     void (*do_work)(async_context_t*, async_at_time_worker_t*);
+    absolute_time_t next_time;
+    void* user_data;
+    // Mock only: position in the owning context's heap
+    size_t heap_index = SIZE_MAX;
+};
+
+struct async_when_pending_worker_t {
+    // Owned by the context the worker is added to
+    async_when_pending_worker_t* next;
+    void (*do_work)(async_context_t*, async_when_pending_worker_t*);
+    // Atomic in the mock so that other threads can play the role of an ISR
+    std::atomic<bool> work_pending{false};
     void* user_data;
 };
 
@@ -28,72 +81,311 @@ struct async_context_poll_t {
     async_context_t core;
 };
 
-// Mock implementations of Pico SDK functions
+// Timer queue helpers used by the mock context
+namespace async_timer_queue {
+    inline bool before(const async_timer_entry_t& a, const async_timer_entry_t& b) {
+        return a.time_us != b.time_us ? a.time_us < b.time_us : a.sequence < b.sequence;
+    }
+
+    inline void place(async_context_t* context, size_t index, const async_timer_entry_t& entry) {
+        context->scheduled_workers[index] = entry;
+        entry.worker->heap_index = index;
+    }
+
+    inline void sift_up(async_context_t* context, size_t index) {
+        auto& heap = context->scheduled_workers;
+        const async_timer_entry_t entry = heap[index];
+        while (index > 0) {
+            const size_t parent = (index - 1) / 2;
+            if (!before(entry, heap[parent])) {
+                break;
+            }
+            place(context, index, heap[parent]);
+            index = parent;
+        }
+        place(context, index, entry);
+    }
+
+    inline void sift_down(async_context_t* context, size_t index) {
+        auto& heap = context->scheduled_workers;
+        const async_timer_entry_t entry = heap[index];
+        const size_t size = heap.size();
+        while (true) {
+            size_t child = 2 * index + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && before(heap[child + 1], heap[child])) {
+                child++;
+            }
+            if (!before(heap[child], entry)) {
+                break;
+            }
+            place(context, index, heap[child]);
+            index = child;
+        }
+        place(context, index, entry);
+    }
+
+    inline bool contains(const async_context_t* context, const async_at_time_worker_t* worker) {
+        const size_t index = worker->heap_index;
+        return index < context->scheduled_workers.size() && context->scheduled_workers[index].worker == worker;
+    }
+
+    inline void push(async_context_t* context, async_at_time_worker_t* worker) {
+        context->scheduled_workers.push_back({worker->next_time, context->next_sequence++, worker});
+        sift_up(context, context->scheduled_workers.size() - 1);
+    }
+
+    // Moves a scheduled worker to the heap position of its current next_time
+    inline void rekey(async_context_t* context, async_at_time_worker_t* worker) {
+        const size_t index = worker->heap_index;
+        auto& entry = context->scheduled_workers[index];
+        const uint64_t old_time = entry.time_us;
+        entry.time_us = to_us_since_boot(worker->next_time);
+        if (entry.time_us < old_time) {
+            sift_up(context, index);
+        } else {
+            sift_down(context, index);
+        }
+    }
+
+    inline void erase(async_context_t* context, size_t index) {
+        auto& heap = context->scheduled_workers;
+        const async_timer_entry_t last = heap.back();
+        heap.pop_back();
+        if (index == heap.size()) {
+            return;
+        }
+        place(context, index, last);
+        if (index > 0 && before(last, heap[(index - 1) / 2])) {
+            sift_up(context, index);
+        } else {
+            sift_down(context, index);
+        }
+    }
+}
+
+// Built-in poll context implementation
+namespace async_context_poll_impl {
+    // Refresh the cached earliest deadline after the worker list changed
+    inline void refresh_next_time(async_context_t* context) {
+        context->next_time = context->scheduled_workers.empty()
+            ? at_the_end_of_time
+            : context->scheduled_workers.front().time_us;
+    }
+
+    inline bool has_pending_work(const async_context_t* context) {
+        for (auto* worker = context->when_pending_list; worker; worker = worker->next) {
+            if (worker->work_pending.load(std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Run the when-pending workers that have been signalled since the last poll
+    inline void run_pending_workers(async_context_t* context) {
+        for (auto* worker = context->when_pending_list; worker; ) {
+            // do_work may remove the worker
+            auto* next = worker->next;
+            if (worker->work_pending.exchange(false, std::memory_order_acq_rel) && worker->do_work) {
+                worker->do_work(context, worker);
+            }
+            worker = next;
+        }
+    }
+
+    inline void poll(async_context_t* context) {
+        // Like the SDK's remove-ready loop, take the earliest due worker one at a time against the
+        // current time, so a worker that do_work reschedules into the past runs again in this poll
+        while (!context->scheduled_workers.empty()) {
+            context->current_time_us = time_us_64();
+            if (context->scheduled_workers.front().time_us > context->current_time_us) {
+                break;
+            }
+            async_at_time_worker_t* worker = context->scheduled_workers.front().worker;
+            async_timer_queue::erase(context, 0);
+            refresh_next_time(context);
+            if (worker->do_work) {
+                worker->do_work(context, worker);
+            }
+        }
+
+        // As in the SDK, when-pending workers run after the due at-time workers
+        run_pending_workers(context);
+    }
+
+    inline bool add_at_time_worker(async_context_t* context, async_at_time_worker_t* worker) {
+        // Like the SDK, a worker that is already scheduled is not added twice, but it is due at
+        // its new next_time, which the SDK reads from the worker itself
+        if (async_timer_queue::contains(context, worker)) {
+            async_timer_queue::rekey(context, worker);
+            refresh_next_time(context);
+            return false;
+        }
+
+        // Schedule the worker
+        async_timer_queue::push(context, worker);
+        refresh_next_time(context);
+        return true;
+    }
+
+    inline bool remove_at_time_worker(async_context_t* context, async_at_time_worker_t* worker) {
+        if (!async_timer_queue::contains(context, worker)) {
+            return false;
+        }
+        async_timer_queue::erase(context, worker->heap_index);
+        refresh_next_time(context);
+        return true;
+    }
+
+    inline void wait_for_work_until(async_context_t* context, absolute_time_t until) {
+        // The poll context sleeps until the next worker is due, work is signalled or the timeout expires
+        const absolute_time_t wake = absolute_time_min(context->next_time, until);
+        while (!has_pending_work(context) && !best_effort_wfe_or_timeout(wake)) {
+        }
+    }
+
+    inline bool add_when_pending_worker(async_context_t* context, async_when_pending_worker_t* worker) {
+        for (auto* other = context->when_pending_list; other; other = other->next) {
+            if (other == worker) {
+                return false;
+            }
+        }
+        worker->next = context->when_pending_list;
+        context->when_pending_list = worker;
+        return true;
+    }
+
+    inline bool remove_when_pending_worker(async_context_t* context, async_when_pending_worker_t* worker) {
+        for (auto** link = &context->when_pending_list; *link; link = &(*link)->next) {
+            if (*link == worker) {
+                *link = worker->next;
+                worker->next = nullptr;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void set_work_pending(async_context_t*, async_when_pending_worker_t* worker) {
+        // Safe from other threads: publish the work, then wake a sleeping poll loop
+        worker->work_pending.store(true, std::memory_order_release);
+        __sev();
+    }
+
+    inline void acquire_lock_blocking(async_context_t*) {}
+    inline void release_lock(async_context_t*) {}
+    inline void lock_check(async_context_t*) {}
+    inline uint32_t execute_sync(async_context_t*, uint32_t (*func)(void* param), void* param) {
+        return func(param);
+    }
+    inline void wait_until(async_context_t*, absolute_time_t until) { sleep_until(until); }
+    inline void deinit(async_context_t*) {}
+}
+
+inline constexpr async_context_type_t async_context_poll_type = {
+    .type = 1,
+    .acquire_lock_blocking = async_context_poll_impl::acquire_lock_blocking,
+    .release_lock = async_context_poll_impl::release_lock,
+    .lock_check = async_context_poll_impl::lock_check,
+    .execute_sync = async_context_poll_impl::execute_sync,
+    .add_at_time_worker = async_context_poll_impl::add_at_time_worker,
+    .remove_at_time_worker = async_context_poll_impl::remove_at_time_worker,
+    .add_when_pending_worker = async_context_poll_impl::add_when_pending_worker,
+    .remove_when_pending_worker = async_context_poll_impl::remove_when_pending_worker,
+    .set_work_pending = async_context_poll_impl::set_work_pending,
+    .poll = async_context_poll_impl::poll,
+    .wait_until = async_context_poll_impl::wait_until,
+    .wait_for_work_until = async_context_poll_impl::wait_for_work_until,
+    .deinit = async_context_poll_impl::deinit,
+};
+
+// Mock implementations of Pico SDK functions, dispatching through the context type
+inline const async_context_type_t* async_context_type_of(const async_context_t* context) {
+    return context->type ? context->type : &async_context_poll_type;
+}
+
 inline void async_context_poll_init_with_defaults(async_context_poll_t* context) {
     // Initialize the context
     if (context) {
+        context->core.type = &async_context_poll_type;
         context->core.scheduled_workers.clear();
+        context->core.when_pending_list = nullptr;
         context->core.current_time_us = time_us_64();
+        context->core.next_time = at_the_end_of_time;
     }
 }
 
 inline void async_context_poll(async_context_t* context) {
-    if (!context || context->scheduled_workers.empty()) {
-        return;
-    }
-    
-    // Update current time
-    context->current_time_us = time_us_64();
-    
-    // Find workers that are ready to run
-    std::vector<async_at_time_worker_t*> ready_workers;
-    
-    // Collect workers that are ready to run
-    auto it = context->scheduled_workers.begin();
-    while (it != context->scheduled_workers.end()) {
-        if (it->first <= context->current_time_us) {
-            ready_workers.push_back(it->second);
-            it = context->scheduled_workers.erase(it);
-        } else {
-            ++it;
-        }
+    if (context && async_context_type_of(context)->poll) {
+        async_context_type_of(context)->poll(context);
     }
-    
-    // Run all ready workers
-    for (auto* worker : ready_workers) {
-        if (worker && worker->do_work) {
-            worker->do_work(context, worker);
-        }
+}
+
+inline bool async_context_add_at_time_worker(async_context_t* context,
+                                             async_at_time_worker_t* worker) {
+    if (!context || !worker) {
+        return false;
     }
+    return async_context_type_of(context)->add_at_time_worker(context, worker);
 }
 
-inline void async_context_add_at_time_worker_in_ms(async_context_t* context, 
-                                                  async_at_time_worker_t* worker, 
-                                                  uint32_t ms) {
+inline bool async_context_add_at_time_worker_at(async_context_t* context,
+                                                async_at_time_worker_t* worker,
+                                                absolute_time_t at) {
     if (!context || !worker) {
-        return;
+        return false;
+    }
+    worker->next_time = at;
+    return async_context_add_at_time_worker(context, worker);
+}
+
+inline bool async_context_add_at_time_worker_in_ms(async_context_t* context,
+                                                  async_at_time_worker_t* worker,
+                                                  uint32_t ms) {
+    if (!context) {
+        return false;
     }
-    
+
     // Calculate the time when the worker should run
-    uint64_t run_time_us = context->current_time_us + (ms * 1000);
-    
-    // Schedule the worker
-    context->scheduled_workers.push_back(std::make_pair(run_time_us, worker));
-    
-    // Sort workers by run time
-    std::sort(context->scheduled_workers.begin(), context->scheduled_workers.end(),
-              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return async_context_add_at_time_worker_at(context, worker, make_timeout_time_ms(ms));
+}
+
+inline bool async_context_remove_at_time_worker(async_context_t* context,
+                                                async_at_time_worker_t* worker) {
+    if (!context || !worker) {
+        return false;
+    }
+    return async_context_type_of(context)->remove_at_time_worker(context, worker);
+}
+
+inline bool async_context_add_when_pending_worker(async_context_t* context,
+                                                  async_when_pending_worker_t* worker) {
+    if (!context || !worker) {
+        return false;
+    }
+    return async_context_type_of(context)->add_when_pending_worker(context, worker);
+}
+
+inline bool async_context_remove_when_pending_worker(async_context_t* context,
+                                                     async_when_pending_worker_t* worker) {
+    if (!context || !worker) {
+        return false;
+    }
+    return async_context_type_of(context)->remove_when_pending_worker(context, worker);
+}
+
+inline void async_context_set_work_pending(async_context_t* context,
+                                           async_when_pending_worker_t* worker) {
+    async_context_type_of(context)->set_work_pending(context, worker);
 }
 
-inline void sleep_ms(uint32_t ms) {
-    // Platform-specific sleep implementation
-    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+inline void async_context_wait_for_work_until(async_context_t* context, absolute_time_t until) {
+    async_context_type_of(context)->wait_for_work_until(context, until);
 }
 
-// Additional mock functions that might be needed
-inline uint64_t time_us_64() {
-    // Return current time in microseconds
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = now.time_since_epoch();
-    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+inline void async_context_wait_for_work_ms(async_context_t* context, uint32_t ms) {
+    async_context_wait_for_work_until(context, make_timeout_time_ms(ms));
 }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <thread>
+
+// Mock of the Pico SDK multicore API (pico/multicore.h)
+//
+// Core 1 is emulated by a std::thread. Unlike the SDK, multicore_reset_core1()
+// cannot stop a running core: it waits for the entry function to return.
+namespace mock_multicore {
+    inline std::thread& core1() {
+        static std::thread thread;
+        return thread;
+    }
+}
+
+inline void multicore_reset_core1() {
+    if (mock_multicore::core1().joinable()) {
+        mock_multicore::core1().join();
+    }
+}
+
+inline void multicore_launch_core1(void (*entry)(void)) {
+    multicore_reset_core1();
+    mock_multicore::core1() = std::thread(entry);
+}
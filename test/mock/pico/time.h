@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+#include <chrono>
+
+#include "hardware/sync.h"
+
+// Mock of the Pico SDK time API (pico/time.h, hardware/timer.h)
+typedef uint64_t absolute_time_t;
+
+inline constexpr absolute_time_t nil_time = 0;
+inline constexpr absolute_time_t at_the_end_of_time = 0x7fffffffffffffffull;
+
+// Simulated time in microseconds, or nullptr to follow the host clock (see VirtualClock)
+inline uint64_t*& mock_virtual_time_us() {
+    static uint64_t* virtual_time_us = nullptr;
+    return virtual_time_us;
+}
+
+inline uint64_t time_us_64() {
+    if (uint64_t* virtual_time_us = mock_virtual_time_us()) {
+        return *virtual_time_us;
+    }
+    
+    // Return current time in microseconds
+    auto now = std::chrono::high_resolution_clock::now();
+    auto duration = now.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+inline absolute_time_t get_absolute_time() {
+    return time_us_64();
+}
+
+inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    // Saturate at the end of time like the SDK does
+    return (us >= at_the_end_of_time - t) ? at_the_end_of_time : t + us;
+}
+
+inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return delayed_by_us(t, uint64_t(ms) * 1000);
+}
+
+inline absolute_time_t make_timeout_time_us(uint64_t us) {
+    return delayed_by_us(get_absolute_time(), us);
+}
+
+inline absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return static_cast<int64_t>(to - from);
+}
+
+inline absolute_time_t absolute_time_min(absolute_time_t a, absolute_time_t b) {
+    return a < b ? a : b;
+}
+
+inline bool time_reached(absolute_time_t t) {
+    return get_absolute_time() >= t;
+}
+
+inline void sleep_until(absolute_time_t t) {
+    // Sleeping on a virtual clock jumps straight to the wakeup time
+    if (uint64_t* virtual_time_us = mock_virtual_time_us()) {
+        if (t > *virtual_time_us) {
+            *virtual_time_us = t;
+        }
+        return;
+    }
+    
+    // Platform-specific sleep implementation
+    auto now = get_absolute_time();
+    if (t > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(t - now));
+    }
+}
+
+inline void sleep_us(uint64_t us) {
+    sleep_until(make_timeout_time_us(us));
+}
+
+inline void sleep_ms(uint32_t ms) {
+    sleep_us(uint64_t(ms) * 1000);
+}
+
+inline void busy_wait_us(uint64_t us) {
+    // Simulated work consumes virtual time without spinning
+    if (uint64_t* virtual_time_us = mock_virtual_time_us()) {
+        *virtual_time_us += us;
+        return;
+    }
+    
+    const absolute_time_t end = make_timeout_time_us(us);
+    while (!time_reached(end)) {
+    }
+}
+
+inline bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    // Returns false when woken by an event, true once the timeout has been reached
+    auto& event_register = mock_event_register::get();
+    std::unique_lock<std::mutex> lock(event_register.mutex);
+    if (!mock_event_register::is_set(event_register)) {
+        if (uint64_t* virtual_time_us = mock_virtual_time_us()) {
+            // Nothing else can happen on a virtual clock, so jump to the timeout
+            if (timeout_timestamp > *virtual_time_us) {
+                *virtual_time_us = timeout_timestamp;
+            }
+            return true;
+        }
+        const absolute_time_t now = get_absolute_time();
+        if (timeout_timestamp <= now) {
+            return true;
+        }
+        const auto has_event = [&]() { return mock_event_register::is_set(event_register); };
+        if (timeout_timestamp - now > 1000000000000ull) {
+            event_register.changed.wait(lock, has_event);
+        } else {
+            event_register.changed.wait_for(lock, std::chrono::microseconds(timeout_timestamp - now), has_event);
+        }
+    }
+    if (mock_event_register::is_set(event_register)) {
+        mock_event_register::clear(event_register);
+        return false;
+    }
+    return time_reached(timeout_timestamp);
+}
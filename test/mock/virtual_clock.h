@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "pico/async_context_poll.h"
+
+/**
+ * @brief Simulated time source for host tests and simulations
+ *
+ * While a VirtualClock is alive, time_us_64() returns its time, sleeping
+ * jumps straight to the wakeup time and busy waiting advances it by the
+ * waited amount. async_context_poll, async_context_wait_for_work_until and
+ * therefore TaskRunner all follow it, so simulated hours of scheduling run
+ * in milliseconds and every run is bit-for-bit deterministic. Clocks nest;
+ * destroying one restores the previous time source. Not thread safe.
+ */
+class VirtualClock {
+private:
+    uint64_t now_us;
+    uint64_t* previous;
+
+public:
+    explicit VirtualClock(uint64_t start_us = 1000000)
+        : now_us(start_us), previous(mock_virtual_time_us()) {
+        mock_virtual_time_us() = &now_us;
+    }
+
+    ~VirtualClock() {
+        mock_virtual_time_us() = previous;
+    }
+
+    VirtualClock(const VirtualClock&) = delete;
+    VirtualClock& operator=(const VirtualClock&) = delete;
+
+    // Current simulated time in microseconds
+    uint64_t now() const { return now_us; }
+
+    // Advance the simulated time by the given amount
+    void advance(uint64_t us) { now_us += us; }
+
+    // Advance the simulated time to an absolute time; never goes backwards
+    void advance_to(absolute_time_t t) {
+        if (to_us_since_boot(t) > now_us) {
+            now_us = to_us_since_boot(t);
+        }
+    }
+
+    // Advance to the earliest deadline of a context; returns false if nothing is scheduled
+    bool advance_to_next_deadline(const async_context_t& context) {
+        if (context.next_time == at_the_end_of_time) {
+            return false;
+        }
+        advance_to(context.next_time);
+        return true;
+    }
+};
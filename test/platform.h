@@ -15,6 +15,7 @@
     #include <vector>
     #include <algorithm>
     #include "mock/pico/async_context_poll.h"
+    #include "mock/virtual_clock.h"
 #endif
 
 // Common platform-independent interface
@@ -31,6 +32,10 @@ namespace test_platform {
     // Get current time in microseconds
     uint64_t time_us_64();
     
+    // Scoped simulated time: on the host, time inside the scope is virtual and
+    // sleeping or waiting for work returns immediately; on the device it is real
+    class SimulatedTime;
+    
     // Platform-specific GPIO operations
     namespace gpio {
         void init(unsigned int pin);
@@ -74,6 +79,9 @@ namespace test_platform {
         return ::time_us_64();  // Use Pico SDK time_us_64
     }
     
+    class SimulatedTime {
+    };
+    
     namespace gpio {
         inline void init(unsigned int pin) {
             gpio_init(pin);
@@ -119,16 +127,20 @@ namespace test_platform {
         // No special cleanup needed for host
     }
     
+    // Go through the mock so that a VirtualClock is honoured
     inline void sleep_ms(uint32_t ms) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        ::sleep_ms(ms);
     }
     
     inline uint64_t time_us_64() {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto duration = now.time_since_epoch();
-        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        return ::time_us_64();
     }
     
+    class SimulatedTime {
+    public:
+        VirtualClock clock;
+    };
+    
     namespace gpio {
         // Mock GPIO implementation for host
         static std::unordered_map<unsigned int, bool> gpio_values;
@@ -153,59 +165,19 @@ namespace test_platform {
     }
     
     namespace async {
+        // The mock context implements the SDK semantics; share it instead of duplicating
         inline void init_context(async_context_poll_t* context) {
-            if (context) {
-                context->core.scheduled_workers.clear();
-                context->core.current_time_us = time_us_64();
-            }
+            async_context_poll_init_with_defaults(context);
         }
         
         inline void poll_context(async_context_t* context) {
-            if (!context || context->scheduled_workers.empty()) {
-                return;
-            }
-            
-            // Update current time
-            context->current_time_us = time_us_64();
-            
-            // Find workers that are ready to run
-            std::vector<async_at_time_worker_t*> ready_workers;
-            
-            // Collect workers that are ready to run
-            auto it = context->scheduled_workers.begin();
-            while (it != context->scheduled_workers.end()) {
-                if (it->first <= context->current_time_us) {
-                    ready_workers.push_back(it->second);
-                    it = context->scheduled_workers.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-            
-            // Run all ready workers
-            for (auto* worker : ready_workers) {
-                if (worker && worker->do_work) {
-                    worker->do_work(context, worker);
-                }
-            }
+            async_context_poll(context);
         }
         
         inline void add_worker_in_ms(async_context_t* context, 
                                     async_at_time_worker_t* worker, 
                                     uint32_t ms) {
-            if (!context || !worker) {
-                return;
-            }
-            
-            // Calculate the time when the worker should run
-            uint64_t run_time_us = context->current_time_us + (ms * 1000);
-            
-            // Schedule the worker
-            context->scheduled_workers.push_back(std::make_pair(run_time_us, worker));
-            
-            // Sort workers by run time
-            std::sort(context->scheduled_workers.begin(), context->scheduled_workers.end(),
-                    [](const auto& a, const auto& b) { return a.first < b.first; });
+            async_context_add_at_time_worker_in_ms(context, worker, ms);
         }
     }
 }
@@ -0,0 +1,139 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskCoroutine.hpp"
+#include <vector>
+
+// Records the time of each step of a warm-up like sequence
+static CoroutineTask warm_up_sequence(std::vector<uint64_t>* steps) {
+    steps->push_back(time_us_64());
+    co_await sleep_for(10);
+    steps->push_back(time_us_64());
+    co_await sleep_for(std::chrono::microseconds{500});
+    steps->push_back(time_us_64());
+    co_await next_tick();
+    steps->push_back(time_us_64());
+}
+
+// Waits for an event a given number of times
+static CoroutineTask event_waiter(TaskEvent* event, int* wakeups, int count) {
+    for (int i = 0; i < count; i++) {
+        co_await *event;
+        (*wakeups)++;
+    }
+}
+
+// Sleeps for a negative duration, which must not be taken as a very long one
+static CoroutineTask sleep_negative(int* steps) {
+    (*steps)++;
+    co_await sleep_for(std::chrono::milliseconds{-5});
+    (*steps)++;
+}
+
+// Never returns on its own
+static CoroutineTask idle_forever() {
+    while (true) {
+        co_await sleep_for(std::chrono::hours{1});
+    }
+}
+
+// Test that sleep_for and next_tick resume the coroutine at the right time
+UTEST(CoroutineTask, SleepForSequence) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> steps;
+    int ticks = 0;
+    auto ticker = create_scheduled_task(1, [&ticks]() { ticks++; });
+    TaskRunner runner(warm_up_sequence(&steps), std::move(ticker));
+    ASSERT_TRUE(runner.get_task<0>().valid());
+
+    // The body starts on the first poll
+    ASSERT_EQ(steps.size(), 0u);
+    runner.poll();
+    ASSERT_EQ(steps.size(), 1u);
+
+    const absolute_time_t end = make_timeout_time_ms(20);
+    while (!time_reached(end) && !runner.get_task<0>().done()) {
+        runner.wait_for_work_until(end);
+        runner.poll();
+    }
+
+    ASSERT_TRUE(runner.get_task<0>().done());
+    ASSERT_EQ(steps.size(), 4u);
+    ASSERT_GE(steps[1] - steps[0], 10000u);
+    ASSERT_GE(steps[2] - steps[1], 500u);
+    ASSERT_GE(steps[3], steps[2]);
+    ASSERT_GT(ticks, 0);
+#ifdef PLATFORM_HOST
+    ASSERT_EQ(steps[1] - steps[0], 10000u);
+    ASSERT_EQ(steps[2] - steps[1], 500u);
+#endif
+}
+
+// Test that a negative sleep resumes at once
+UTEST(CoroutineTask, SleepForNegative) {
+    test_platform::SimulatedTime simulated_time;
+    int steps = 0;
+    TaskRunner runner(sleep_negative(&steps));
+    runner.poll();
+    runner.poll();
+    ASSERT_EQ(steps, 2);
+    ASSERT_TRUE(runner.get_task<0>().done());
+}
+
+// Test that co_await on an event resumes once per signal
+UTEST(CoroutineTask, AwaitEvent) {
+    test_platform::SimulatedTime simulated_time;
+    TaskEvent event;
+    int wakeups = 0;
+    auto signaller = create_scheduled_task(5, [&event]() { event.signal(); });
+    TaskRunner runner(event_waiter(&event, &wakeups, 3), std::move(signaller));
+
+    // The coroutine suspends first; the signal from the same poll wakes it after the timers
+    runner.poll();
+    ASSERT_EQ(wakeups, 1);
+
+    // Later signals wake the waiting coroutine on the same poll, without a timer
+    const absolute_time_t end = make_timeout_time_ms(100);
+    while (!time_reached(end) && !runner.get_task<0>().done()) {
+        runner.wait_for_work_until(end);
+        runner.poll();
+    }
+    ASSERT_EQ(wakeups, 3);
+    ASSERT_TRUE(runner.get_task<0>().done());
+}
+
+// Test that frames come from the fixed-capacity arena
+UTEST(CoroutineTask, ArenaCapacity) {
+    using TinyTask = BasicCoroutineTask<256, 2>;
+    auto make = []() -> TinyTask { co_return; };
+    auto too_large = []() -> BasicCoroutineTask<16, 1> { co_return; };
+
+    {
+        TinyTask first = make();
+        TinyTask second = make();
+        TinyTask third = make();
+        ASSERT_TRUE(first.valid());
+        ASSERT_TRUE(second.valid());
+        ASSERT_FALSE(third.valid());
+    }
+
+    // Destroyed tasks return their frames
+    TinyTask again = make();
+    ASSERT_TRUE(again.valid());
+    ASSERT_FALSE(too_large().valid());
+}
+
+// Test that destroying a suspended coroutine removes its workers
+UTEST(CoroutineTask, DestroyWhileSuspended) {
+    test_platform::SimulatedTime simulated_time;
+    async_context_poll_t context;
+    async_context_poll_init_with_defaults(&context);
+    {
+        CoroutineTask task = idle_forever();
+        task.attach(context.core);
+        async_context_poll(&context.core);
+        ASSERT_FALSE(task.done());
+        ASSERT_NE(context.core.next_time, at_the_end_of_time);
+    }
+    ASSERT_EQ(context.core.next_time, at_the_end_of_time);
+    async_context_poll(&context.core);
+}
@@ -0,0 +1,93 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskCyclicExecutive.hpp"
+#include <vector>
+
+static void do_nothing() {}
+
+using Fast = FixedPeriodTask<10000, void (*)()>;
+using Medium = FixedPeriodTask<20000, void (*)()>;
+using Slow = FixedPeriodTask<50000, void (*)()>;
+using Executive = CyclicExecutive<Fast, Medium, Slow>;
+
+// Test the minor frame, hyperperiod and generated table
+UTEST(CyclicExecutive, ScheduleTable) {
+    static_assert(Executive::minor_frame == std::chrono::milliseconds{10});
+    static_assert(Executive::hyperperiod == std::chrono::milliseconds{100});
+    static_assert(std::is_same_v<Executive::Mask, uint8_t>);
+    ASSERT_EQ(Executive::frames, 10u);
+
+    // Bit 0 is the 10ms task, bit 1 the 20ms task and bit 2 the 50ms task
+    const std::array<uint8_t, 10> expected = {0b111, 0b001, 0b011, 0b001, 0b011, 0b101, 0b011, 0b001, 0b011, 0b001};
+    ASSERT_TRUE(Executive::schedule == expected);
+
+    // Periods that are not multiples of each other give a finer minor frame
+    using Mixed = CyclicExecutive<FixedPeriodTask<250, void (*)()>,
+                                  FixedPeriodTask<1000, void (*)()>,
+                                  FixedPeriodTask<1500, void (*)()>>;
+    ASSERT_EQ(Mixed::minor_frame.count(), 250);
+    ASSERT_EQ(Mixed::hyperperiod.count(), 3000);
+    ASSERT_EQ(Mixed::frames, 12u);
+    ASSERT_EQ(Mixed::schedule[0], 0b111);
+    ASSERT_EQ(Mixed::schedule[4], 0b011);
+    ASSERT_EQ(Mixed::schedule[6], 0b101);
+    ASSERT_EQ(Mixed::schedule[7], 0b001);
+}
+
+// Test that tasks run exactly on their frames over several hyperperiods
+UTEST(CyclicExecutive, RunsTable) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> fast_times;
+    int medium_runs = 0;
+    int slow_runs = 0;
+    CyclicExecutive executive(create_scheduled_task<10>([&fast_times]() { fast_times.push_back(time_us_64()); }),
+                              create_scheduled_task<20>([&medium_runs]() { medium_runs++; }),
+                              create_scheduled_task<50>([&slow_runs]() { slow_runs++; busy_wait_us(2000); }));
+
+    // Three hyperperiods
+    for (size_t i = 0; i < 3 * decltype(executive)::frames; i++) {
+        executive.wait_for_work_until(at_the_end_of_time);
+        executive.poll();
+    }
+
+    ASSERT_EQ(fast_times.size(), 30u);
+    ASSERT_EQ(medium_runs, 15);
+    ASSERT_EQ(slow_runs, 6);
+    ASSERT_EQ(executive.get_frame(), 0u);
+    ASSERT_EQ(executive.get_frame_overruns(), 0u);
+#ifdef PLATFORM_HOST
+    // No jitter: the 10ms task runs first in every frame
+    for (size_t i = 1; i < fast_times.size(); i++) {
+        ASSERT_EQ(fast_times[i] - fast_times[i - 1], 10000u);
+    }
+#endif
+}
+
+// Test that frames ending after the next frame start are counted and caught up in order
+UTEST(CyclicExecutive, FrameOverrun) {
+    test_platform::SimulatedTime simulated_time;
+    int fast_runs = 0;
+    CyclicExecutive executive(create_scheduled_task<1>([&fast_runs]() { fast_runs++; }),
+                              create_scheduled_task<4>([]() { busy_wait_us(2500); }));
+    const absolute_time_t start = executive.get_next_deadline();
+
+    const absolute_time_t end = delayed_by_us(start, 8000);
+    while (absolute_time_diff_us(executive.get_next_deadline(), end) > 0) {
+        executive.wait_for_work_until(end);
+        executive.poll();
+    }
+
+    // Frames 0 and 4 overrun into frames 1 and 5, which also end late; no frame is dropped
+    ASSERT_EQ(fast_runs, 8);
+    ASSERT_EQ(executive.get_frame_overruns(), 4u);
+    ASSERT_EQ(executive.get_frame(), 0u);
+}
+
+// Test that tick() advances regardless of the time, for use from a hardware timer
+UTEST(CyclicExecutive, ExternalTick) {
+    Executive executive{Fast(&do_nothing), Medium(&do_nothing), Slow(&do_nothing)};
+    for (size_t i = 0; i < 7; i++) {
+        executive.tick();
+    }
+    ASSERT_EQ(executive.get_frame(), 7u);
+}
@@ -0,0 +1,270 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskMulticore.hpp"
+#include "../src/mameTaskPool.hpp"
+#include <atomic>
+#ifdef PLATFORM_HOST
+#include <memory>
+#include <thread>
+#endif
+
+using namespace std::chrono_literals;
+
+// Test that posted jobs run in order on the next poll, including jobs posted before attach
+UTEST(CoreMailbox, PostRunsOnNextPoll) {
+    int trace[4] = {};
+    int* next = trace;
+    CoreMailbox<4> mailbox;
+    ASSERT_TRUE(mailbox.post([&next]() { *next++ = 1; }));
+    TaskRunner runner(std::move(mailbox));
+    auto& moved = runner.get_task<0>();
+
+    runner.poll();
+    ASSERT_EQ(trace[0], 1);
+
+    ASSERT_TRUE(moved.post([&next]() { *next++ = 2; }));
+    ASSERT_TRUE(moved.post([&next]() { *next++ = 3; }));
+    ASSERT_TRUE(moved.post([&next]() { *next++ = 4; }));
+    ASSERT_TRUE(moved.post([]() {}));
+    ASSERT_FALSE(moved.post([]() {}));
+    // No timer is involved
+    ASSERT_EQ(to_us_since_boot(runner.get_next_deadline()), to_us_since_boot(at_the_end_of_time));
+    runner.poll();
+    ASSERT_EQ(trace[1], 2);
+    ASSERT_EQ(trace[2], 3);
+    ASSERT_EQ(trace[3], 4);
+    ASSERT_EQ(next, trace + 4);
+}
+
+// Test that the owner runs the newest job first while a thief takes the oldest
+UTEST(JobDeque, OwnerTakesNewestThiefOldest) {
+    int trace[4] = {};
+    int* next = trace;
+    TaskRunner runner(JobDeque<4>{});
+    auto& jobs = runner.get_task<0>();
+
+    for (int i = 1; i <= 4; i++) {
+        ASSERT_TRUE(jobs.push([&next, i]() { *next++ = i; }));
+    }
+    ASSERT_FALSE(jobs.push([]() {}));
+    ASSERT_EQ(jobs.size(), 4u);
+
+    ASSERT_TRUE(jobs.run_stolen());
+    // One job per poll
+    runner.poll();
+    ASSERT_EQ(jobs.size(), 2u);
+    runner.poll();
+    runner.poll();
+    ASSERT_TRUE(jobs.empty());
+    ASSERT_FALSE(jobs.run_stolen());
+    runner.poll();
+    ASSERT_EQ(next, trace + 4);
+    ASSERT_EQ(trace[0], 1);
+    ASSERT_EQ(trace[1], 4);
+    ASSERT_EQ(trace[2], 3);
+    ASSERT_EQ(trace[3], 2);
+}
+
+#ifdef PLATFORM_HOST
+// Runs core 0's loop until the condition holds or a second has passed
+template<typename Runner, typename Condition>
+static void run_core0_until(Runner& runner, Condition&& condition) {
+    const absolute_time_t end = make_timeout_time_ms(1000);
+    while (!condition() && !time_reached(end)) {
+        runner.wait_for_work_until(make_timeout_time_ms(1));
+        runner.poll();
+    }
+}
+
+// Test that jobs posted to core 1 run on the emulated core while core 0 keeps its own tasks
+UTEST(DualCoreRunner, PostRunsOnCore1) {
+    std::atomic<int> core0_runs{0};
+    TaskRunner runner0(create_scheduled_task(1ms, [&core0_runs]() { core0_runs++; }));
+    TaskRunner runner1(CoreMailbox<>{});
+    DualCoreRunner cores(runner0, runner1);
+    cores.launch_core1();
+    ASSERT_TRUE(cores.is_core1_running());
+
+    std::atomic<std::thread::id> core1_thread{};
+    std::atomic<int> jobs{0};
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(cores.post<1>([&core1_thread, &jobs]() {
+            core1_thread = std::this_thread::get_id();
+            jobs++;
+        }));
+    }
+    run_core0_until(runner0, [&]() { return jobs == 8 && core0_runs >= 5; });
+    cores.stop_core1();
+
+    ASSERT_EQ(jobs.load(), 8);
+    ASSERT_GE(core0_runs.load(), 5);
+    ASSERT_FALSE(cores.is_core1_running());
+    ASSERT_TRUE(core1_thread.load() != std::thread::id{});
+    ASSERT_TRUE(core1_thread.load() != std::this_thread::get_id());
+}
+
+// Test round trips between the cores through both mailboxes
+UTEST(DualCoreRunner, PingPong) {
+    constexpr int round_trips = 1000;
+    using Runner = TaskRunner<CoreMailbox<>>;
+    Runner runner0(CoreMailbox<>{});
+    Runner runner1(CoreMailbox<>{});
+    DualCoreRunner cores(runner0, runner1);
+    cores.launch_core1();
+
+    std::atomic<int> pongs{0};
+    auto* const dual = &cores;
+    auto* const counter = &pongs;
+    for (int i = 0; i < round_trips; i++) {
+        // Ping on core 1, which answers on core 0
+        while (!cores.post<1>([dual, counter]() {
+            while (!dual->post<0>([counter]() { counter->fetch_add(1, std::memory_order_relaxed); })) {
+            }
+        })) {
+            runner0.wait_for_work_until(make_timeout_time_ms(1));
+            runner0.poll();
+        }
+        runner0.poll();
+    }
+    run_core0_until(runner0, [&]() { return pongs == round_trips; });
+    cores.stop_core1();
+
+    ASSERT_EQ(pongs.load(), round_trips);
+}
+
+// Test migrating a periodic task from core 0's pool to core 1's pool
+UTEST(DualCoreRunner, MigrateTask) {
+    using Runner = TaskRunner<CoreMailbox<>, TaskPool<4, 64>>;
+    Runner runner0(CoreMailbox<>{}, TaskPool<4, 64>{});
+    Runner runner1(CoreMailbox<>{}, TaskPool<4, 64>{});
+    DualCoreRunner cores(runner0, runner1);
+    cores.launch_core1();
+
+    // Jobs must be small, so they carry a pointer to the target's state
+    struct Target {
+        TaskPool<4, 64>* pool;
+        std::atomic<int> runs{0};
+        std::atomic<std::thread::id> thread{};
+    } target{&runner1.get_task<1>()};
+    auto* const migrated = &target;
+
+    std::atomic<int> core0_runs{0};
+    auto& pool0 = runner0.get_task<1>();
+    PoolTaskHandle handle;
+    handle = pool0.spawn([&pool0, &handle, &core0_runs, &cores, migrated]() {
+        if (++core0_runs == 3) {
+            // Cancel here, then respawn on core 1 with the same period
+            pool0.cancel(handle);
+            cores.post<1>([migrated]() {
+                migrated->pool->spawn([migrated]() {
+                    migrated->thread = std::this_thread::get_id();
+                    migrated->runs++;
+                }, 0ms, 1ms);
+            });
+        }
+    }, 0ms, 1ms);
+
+    run_core0_until(runner0, [&]() { return target.runs >= 3; });
+    cores.stop_core1();
+
+    ASSERT_EQ(core0_runs.load(), 3);
+    ASSERT_GE(target.runs.load(), 3);
+    ASSERT_FALSE(pool0.is_active(handle));
+    ASSERT_EQ(pool0.size(), 0u);
+    ASSERT_TRUE(target.thread.load() != std::this_thread::get_id());
+}
+
+// Test that every job runs exactly once while a thief thread steals from the owner
+UTEST(JobDeque, ThreadStress) {
+    constexpr uint32_t total = 200000;
+    auto runs = std::make_unique<std::atomic<uint8_t>[]>(total);
+    auto* const counts = runs.get();
+    std::atomic<uint32_t> stolen{0};
+    TaskRunner runner(JobDeque<64>{});
+    auto& jobs = runner.get_task<0>();
+
+    std::atomic<bool> finished{false};
+    std::thread thief([&]() {
+        while (!finished.load(std::memory_order_acquire)) {
+            if (jobs.run_stolen()) {
+                stolen++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (uint32_t i = 0; i < total; i++) {
+        while (!jobs.push([counts, i]() { counts[i]++; })) {
+            runner.poll();
+        }
+    }
+    while (!jobs.empty()) {
+        runner.poll();
+    }
+    finished.store(true, std::memory_order_release);
+    thief.join();
+
+    uint32_t once = 0;
+    for (uint32_t i = 0; i < total; i++) {
+        once += counts[i] == 1;
+    }
+    ASSERT_EQ(once, total);
+    ASSERT_LE(stolen.load(), total);
+}
+
+// Test that an idle core steals a burst of jobs while the busy core keeps its periodic task
+UTEST(DualCoreRunner, IdleCoreSteals) {
+    constexpr int burst = 32;
+    std::atomic<int> ticks{0};
+    TaskRunner runner0(create_scheduled_task(1ms, [&ticks]() { ticks++; }), JobDeque<64>{});
+    TaskRunner runner1(CoreMailbox<>{});
+    DualCoreRunner cores(runner0, runner1);
+    cores.launch_core1();
+
+    struct Burst {
+        std::thread::id core0;
+        std::atomic<int> on_core0{0};
+        std::atomic<int> on_core1{0};
+    } counts{std::this_thread::get_id()};
+    auto* const stats = &counts;
+    // Let core 1 go to sleep first
+    std::this_thread::sleep_for(5ms);
+    for (int i = 0; i < burst; i++) {
+        ASSERT_TRUE(cores.push_job<0>([stats]() {
+            std::this_thread::sleep_for(1ms);
+            (std::this_thread::get_id() == stats->core0 ? stats->on_core0 : stats->on_core1)++;
+        }));
+    }
+    const int ticks_before = ticks;
+    run_core0_until(runner0, [&]() { return counts.on_core0 + counts.on_core1 == burst; });
+    cores.stop_core1();
+
+    ASSERT_EQ(counts.on_core0 + counts.on_core1, burst);
+    ASSERT_GT(counts.on_core1.load(), 0);
+    // The periodic task ran after every job that core 0 ran itself
+    ASSERT_GE(ticks - ticks_before, counts.on_core0 - 1);
+}
+
+// Test that stolen jobs count as runs and busy time of the thief's runner
+UTEST(DualCoreRunner, StealCountsOnThief) {
+    test_platform::SimulatedTime simulated_time;
+    TaskRunner runner0(JobDeque<4>{});
+    TaskRunner runner1(CoreMailbox<>{});
+    DualCoreRunner cores(runner0, runner1);
+    auto& jobs = runner0.get_task<0>();
+    ASSERT_TRUE(jobs.push([]() { busy_wait_us(300); }));
+    ASSERT_TRUE(jobs.push([]() { busy_wait_us(300); }));
+
+    // Core 1 is not launched; the test thread steals in its place
+    ASSERT_TRUE(cores.steal<1>());
+    ASSERT_TRUE(cores.steal<1>());
+    ASSERT_FALSE(cores.steal<1>());
+
+    CpuLoad const& thief = runner1.get_cpu_load();
+    ASSERT_EQ(thief.runs, 2u);
+    ASSERT_EQ(thief.busy_us, 600u);
+    CpuLoad const& victim = runner0.get_cpu_load();
+    ASSERT_EQ(victim.runs, 0u);
+    ASSERT_EQ(victim.busy_us, 0u);
+}
+#endif
@@ -0,0 +1,202 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskPool.hpp"
+#include <chrono>
+#ifdef PLATFORM_HOST
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+using namespace std::chrono_literals;
+
+using Pool = TaskPool<4, 32>;
+
+// Runs the runner loop for the given time
+template<typename Runner>
+static void run_pool_for_ms(Runner& runner, uint32_t ms) {
+    const absolute_time_t end = make_timeout_time_ms(ms);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+}
+
+// Test that one-shot tasks run once on the next poll and free their slot
+UTEST(TaskPool, SpawnOnce) {
+    int runs = 0;
+    TaskRunner runner(Pool{});
+    Pool& pool = runner.get_task<0>();
+
+    PoolTaskHandle handle = pool.spawn([&runs]() { runs++; });
+    ASSERT_TRUE(static_cast<bool>(handle));
+    ASSERT_TRUE(pool.is_active(handle));
+    ASSERT_EQ(pool.size(), 1u);
+
+    runner.poll();
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+    ASSERT_FALSE(pool.is_active(handle));
+    ASSERT_EQ(pool.size(), 0u);
+
+    // A stale handle does not cancel the task that reuses its slot
+    PoolTaskHandle reused = pool.spawn([&runs]() { runs++; });
+    ASSERT_EQ(reused.index, handle.index);
+    ASSERT_FALSE(pool.cancel(handle));
+    ASSERT_TRUE(pool.cancel(reused));
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+}
+
+// Test periodic tasks, cancellation and a full pool
+UTEST(TaskPool, PeriodicAndCancel) {
+    test_platform::SimulatedTime simulated_time;
+    int fast_runs = 0;
+    int slow_runs = 0;
+    TaskRunner runner(Pool{});
+    Pool& pool = runner.get_task<0>();
+
+    PoolTaskHandle fast = pool.spawn([&fast_runs]() { fast_runs++; }, 0ms, 5ms);
+    PoolTaskHandle slow = pool.spawn([&slow_runs]() { slow_runs++; }, 10ms, 10ms);
+    pool.spawn([]() {}, 1h);
+    pool.spawn([]() {}, 1h);
+    ASSERT_FALSE(static_cast<bool>(pool.spawn([]() {})));
+
+    run_pool_for_ms(runner, 50);
+    ASSERT_EQ(fast_runs, 10);
+    ASSERT_EQ(slow_runs, 4);
+
+    ASSERT_TRUE(pool.cancel(fast));
+    ASSERT_FALSE(pool.cancel(fast));
+    run_pool_for_ms(runner, 50);
+    ASSERT_EQ(fast_runs, 10);
+    ASSERT_EQ(slow_runs, 9);
+    ASSERT_TRUE(pool.is_active(slow));
+    ASSERT_EQ(pool.size(), 3u);
+}
+
+// Test that tasks can cancel themselves and spawn follow-ups from their callback
+UTEST(TaskPool, SpawnAndCancelFromCallbacks) {
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    int follow_ups = 0;
+    // The callback captures five references, so it needs larger slots
+    TaskRunner runner(TaskPool<4, 64>{});
+    auto& pool = runner.get_task<0>();
+
+    PoolTaskHandle self;
+    self = pool.spawn([&]() {
+        if (++runs == 3) {
+            ASSERT_TRUE(pool.cancel(self));
+            pool.spawn([&follow_ups]() { follow_ups++; });
+        }
+    }, 0ms, 1ms);
+
+    run_pool_for_ms(runner, 10);
+    ASSERT_EQ(runs, 3);
+    ASSERT_EQ(follow_ups, 1);
+    ASSERT_FALSE(pool.is_active(self));
+    ASSERT_EQ(pool.size(), 0u);
+}
+
+// Test that tasks spawned before the pool is moved into the runner survive the move
+UTEST(TaskPool, SpawnBeforeAttach) {
+    int runs = 0;
+    Pool pool;
+    pool.spawn([&runs]() { runs++; });
+    TaskRunner runner(std::move(pool));
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+}
+
+// Test periods beyond 32 bits of microseconds and the rejection of negative durations
+UTEST(TaskPool, LongAndNegativeDurations) {
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    TaskRunner runner(Pool{});
+    Pool& pool = runner.get_task<0>();
+
+    // Two hours is 7.2e9us, which does not fit in 32 bits
+    ASSERT_TRUE(static_cast<bool>(pool.spawn([&runs]() { runs++; }, 0ms, 2h)));
+    ASSERT_FALSE(static_cast<bool>(pool.spawn([]() {}, -1ms)));
+    ASSERT_FALSE(static_cast<bool>(pool.spawn([]() {}, 0ms, -1ms)));
+    ASSERT_EQ(pool.size(), 1u);
+
+    run_pool_for_ms(runner, 2 * 3600 * 1000 + 1);
+    ASSERT_EQ(runs, 2);
+}
+
+#ifdef PLATFORM_HOST
+// Heap allocations made by the whole test binary
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Test one million spawns and cancellations without a single heap allocation
+UTEST(TaskPool, MillionSpawnsWithoutAllocation) {
+    test_platform::SimulatedTime simulated_time;
+    constexpr uint32_t spawns = 1000000;
+    constexpr size_t slots = 64;
+    uint64_t runs = 0;
+    uint32_t state = 12345;
+    auto random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+
+    auto runner = std::make_unique<TaskRunner<TaskPool<slots, 32>>>(TaskPool<slots, 32>{});
+    auto& pool = runner->get_task<0>();
+    std::array<PoolTaskHandle, slots> handles{};
+
+    // Grow the mock context's queues to their largest size first
+    for (size_t i = 0; i < slots; i++) {
+        pool.spawn([&runs]() { runs++; });
+    }
+    runner->poll();
+    ASSERT_EQ(pool.size(), 0u);
+
+    const uint64_t runs_before = runs;
+    const uint64_t allocations_before = g_allocations.load();
+    uint64_t cancelled = 0;
+    for (uint32_t i = 0; i < spawns; i++) {
+        PoolTaskHandle& handle = handles[random() % slots];
+        if (pool.cancel(handle)) {
+            cancelled++;
+        }
+        const uint32_t r = random();
+        // Fills the 32-byte slot together with the reference
+        const std::array<uint64_t, 3> capture = {i, r, runs};
+        if (r % 4 == 0) {
+            handle = pool.spawn([&runs, capture]() { (void)capture; runs++; });
+        } else {
+            handle = pool.spawn([&runs]() { runs++; }, std::chrono::microseconds{r % 1000});
+        }
+        ASSERT_TRUE(static_cast<bool>(handle));
+        if (i % 16 == 0) {
+            busy_wait_us(100);
+            runner->poll();
+        }
+    }
+    const uint64_t allocations = g_allocations.load() - allocations_before;
+
+    // Every spawn either ran, was cancelled or is still waiting
+    ASSERT_EQ(allocations, 0u);
+    ASSERT_EQ(runs - runs_before + cancelled + pool.size(), static_cast<uint64_t>(spawns));
+    ASSERT_GT(runs, 0u);
+    ASSERT_GT(cancelled, 0u);
+}
+#endif
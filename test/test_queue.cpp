@@ -0,0 +1,163 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskQueue.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+#ifdef PLATFORM_HOST
+#include <atomic>
+#include <thread>
+#endif
+
+// Test FIFO order, capacity and wrap-around of the single-producer queue
+UTEST(SpscQueue, FifoAndCapacity) {
+    SpscQueue<uint32_t, 4> queue;
+    uint32_t value = 0;
+    ASSERT_FALSE(queue.pop(value));
+
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_TRUE(queue.push(round * 10 + i));
+        }
+        ASSERT_FALSE(queue.push(99u));
+        ASSERT_EQ(queue.size(), 4u);
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_TRUE(queue.pop(value));
+            ASSERT_EQ(value, round * 10 + i);
+        }
+        ASSERT_TRUE(queue.empty());
+    }
+
+    // Move-only elements are moved through the ring
+    SpscQueue<std::unique_ptr<int>, 2> owned;
+    ASSERT_TRUE(owned.push(std::make_unique<int>(7)));
+    std::unique_ptr<int> out;
+    ASSERT_TRUE(owned.pop(out));
+    ASSERT_EQ(*out, 7);
+}
+
+// Test FIFO order, capacity and wrap-around of the multi-producer queue
+UTEST(MpscQueue, FifoAndCapacity) {
+    MpscQueue<uint32_t, 4> queue;
+    uint32_t value = 0;
+    ASSERT_FALSE(queue.pop(value));
+
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_TRUE(queue.push(round * 10 + i));
+        }
+        ASSERT_FALSE(queue.push(99u));
+        std::vector<uint32_t> drained;
+        ASSERT_EQ(queue.drain([&drained](uint32_t v) { drained.push_back(v); }), 4u);
+        ASSERT_EQ(drained.size(), 4u);
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_EQ(drained[i], round * 10 + i);
+        }
+        ASSERT_TRUE(queue.empty());
+    }
+}
+
+// Test that a push makes the consumer task run on the next poll instead of on a timer
+UTEST(SpscQueue, PushSignalsConsumer) {
+    SpscQueue<uint16_t, 8> samples;
+    uint32_t sum = 0;
+    int runs = 0;
+    TaskRunner runner(create_event_task([&]() {
+        runs++;
+        samples.drain([&sum](uint16_t sample) { sum += sample; });
+    }));
+    samples.set_consumer(runner.get_task<0>());
+
+    runner.poll();
+    ASSERT_EQ(runs, 0);
+
+    samples.push(uint16_t{100});
+    samples.push(uint16_t{200});
+    // No timer is involved
+    ASSERT_EQ(to_us_since_boot(runner.get_next_deadline()), to_us_since_boot(at_the_end_of_time));
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+    ASSERT_EQ(sum, 300u);
+
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+}
+
+#ifdef PLATFORM_HOST
+// Test one producer thread feeding a consumer task that only wakes on pushes
+UTEST(SpscQueue, ThreadStress) {
+    constexpr uint32_t messages = 1000000;
+    SpscQueue<uint32_t, 256> queue;
+    uint32_t expected = 0;
+    bool in_order = true;
+    TaskRunner runner(create_event_task([&]() {
+        queue.drain([&](uint32_t value) {
+            in_order = in_order && value == expected;
+            expected++;
+        });
+    }));
+    queue.set_consumer(runner.get_task<0>());
+
+    std::thread producer([&queue]() {
+        for (uint32_t i = 0; i < messages; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    const absolute_time_t end = make_timeout_time_ms(30000);
+    while (expected < messages && !time_reached(end)) {
+        runner.wait_for_work_until(end);
+        runner.poll();
+    }
+    producer.join();
+
+    ASSERT_EQ(expected, messages);
+    ASSERT_TRUE(in_order);
+    ASSERT_TRUE(queue.empty());
+}
+
+// Test four producer threads; each producer's messages arrive complete and in order
+UTEST(MpscQueue, ThreadStress) {
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t per_producer = 250000;
+    MpscQueue<uint32_t, 256> queue;
+    std::array<uint32_t, producers> next{};
+    uint32_t received = 0;
+    bool in_order = true;
+    TaskRunner runner(create_event_task([&]() {
+        queue.drain([&](uint32_t value) {
+            const uint32_t producer = value >> 24;
+            in_order = in_order && producer < producers && (value & 0xFFFFFF) == next[producer];
+            next[producer & 3]++;
+            received++;
+        });
+    }));
+    queue.set_consumer(runner.get_task<0>());
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p]() {
+            for (uint32_t i = 0; i < per_producer; i++) {
+                while (!queue.push(p << 24 | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    const absolute_time_t end = make_timeout_time_ms(30000);
+    while (received < producers * per_producer && !time_reached(end)) {
+        runner.wait_for_work_until(end);
+        runner.poll();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(received, producers * per_producer);
+    ASSERT_TRUE(in_order);
+    for (uint32_t count : next) {
+        ASSERT_EQ(count, per_producer);
+    }
+}
+#endif
@@ -3,6 +3,10 @@
 #include "../src/mameTaskPico.hpp"
 #include <vector>
 #include <chrono>
+#ifdef PLATFORM_HOST
+#include <atomic>
+#include <thread>
+#endif
 
 // Global counters for tests
 static int g_counter1 = 0;
@@ -22,7 +26,8 @@ struct MockTask {
     int* counter_ptr;
     unsigned interval_ms;
     
-    MockTask(int* counter, unsigned interval = 0) 
+    // A zero interval would make the worker due again at once and, as in the SDK, spin in one poll
+    MockTask(int* counter, unsigned interval = 1) 
         : counter_ptr(counter), interval_ms(interval) {
         worker.do_work = [](async_context_t* context, async_at_time_worker_t* worker) {
             // Cast back to MockTask to access the counter
@@ -121,6 +126,8 @@ UTEST(TaskRunner, TaskExecution) {
 
 // Test that tasks are executed at the correct intervals
 UTEST(TaskRunner, ExecutionTiming) {
+    test_platform::SimulatedTime simulated_time;
+    
     // Create a vector to store execution times
     std::vector<uint64_t> execution_times;
     
@@ -152,6 +159,8 @@ UTEST(TaskRunner, ExecutionTiming) {
 
 // Test that tasks with different priorities are executed in the correct order
 UTEST(TaskRunner, MultipleTaskPriority) {
+    test_platform::SimulatedTime simulated_time;
+    
     // Reset counters
     reset_counters();
     
@@ -222,6 +231,671 @@ UTEST(TaskRunner, MultipleTaskPriority) {
     ASSERT_GE(count2, count3); // Task 2 should execute at least as often as Task 3
 }
 
+// Test that the tickless loop wakes up once per task deadline
+UTEST(TaskRunner, TicklessWakeups) {
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    auto task = create_scheduled_task(20, [&runs]() { runs++; });
+    TaskRunner runner(std::move(task));
+    
+    // Drive the same loop as run_forever() for a bounded time
+    const absolute_time_t end = make_timeout_time_ms(100);
+    int wakeups = 0;
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+        wakeups++;
+    }
+    
+    // A 10ms fixed tick would have woken up ten times
+    ASSERT_GE(runs, 4);
+    ASSERT_LE(wakeups, runs + 1);
+}
+
+// Test that the next deadline reflects the earliest scheduled task
+UTEST(TaskRunner, NextDeadline) {
+    test_platform::SimulatedTime simulated_time;
+    auto slow_task = create_scheduled_task(500, []() {});
+    auto fast_task = create_scheduled_task(50, []() {});
+    TaskRunner runner(std::move(slow_task), std::move(fast_task));
+    
+    // Both tasks are due immediately after construction
+    ASSERT_TRUE(time_reached(runner.get_next_deadline()));
+    
+    // After the first poll the fast task determines the next wakeup
+    runner.poll();
+    int64_t until_next_us = absolute_time_diff_us(get_absolute_time(), runner.get_next_deadline());
+    ASSERT_GT(until_next_us, 0);
+    ASSERT_LE(until_next_us, 50000);
+}
+
+// Test that a runner on a shared context takes its tasks off the context when it is destroyed
+UTEST(TaskRunner, DestroyedOnSharedContext) {
+    test_platform::SimulatedTime simulated_time;
+    async_context_poll_t shared;
+    async_context_poll_init_with_defaults(&shared);
+    int runs = 0;
+    {
+        TaskRunner runner(shared.core,
+                          create_scheduled_task(1, [&runs]() { runs++; }),
+                          create_scheduled_task<1>([&runs]() { runs++; }),
+                          create_event_task([&runs]() { runs++; }));
+        runner.poll();
+        ASSERT_EQ(runs, 2);
+        // Still due or pending when the runner goes away
+        runner.get_task<2>().signal();
+        test_platform::sleep_ms(1);
+    }
+    
+    // The context stays in use; none of the freed tasks may run
+    ASSERT_TRUE(shared.core.when_pending_list == nullptr);
+    ASSERT_EQ(to_us_since_boot(shared.core.next_time), to_us_since_boot(at_the_end_of_time));
+    for (int i = 0; i < 3; i++) {
+        test_platform::sleep_ms(1);
+        async_context_poll(&shared.core);
+    }
+    ASSERT_EQ(runs, 2);
+}
+
+// Test that a signalled event task runs on the next poll without a timer
+UTEST(EventTask, RunsOnNextPoll) {
+    test_platform::SimulatedTime simulated_time;
+    int events = 0;
+    int ticks = 0;
+    auto event_task = create_event_task([&events]() { events++; });
+    auto slow_task = create_scheduled_task(1000, [&ticks]() { ticks++; });
+    TaskRunner runner(std::move(event_task), std::move(slow_task));
+    
+    runner.poll();
+    ASSERT_EQ(events, 0);
+    ASSERT_EQ(ticks, 1);
+    
+    // Signals before the next poll are coalesced into one run
+    runner.get_task<0>().signal();
+    runner.get_task<0>().signal();
+    const absolute_time_t signalled_at = get_absolute_time();
+    runner.wait_for_work_until(at_the_end_of_time);
+    ASSERT_FALSE(time_reached(delayed_by_us(signalled_at, 1000)));
+    runner.poll();
+    ASSERT_EQ(events, 1);
+    ASSERT_EQ(ticks, 1);
+    
+    // Nothing pending: the loop sleeps until the periodic task is due
+    runner.poll();
+    ASSERT_EQ(events, 1);
+}
+
+// Test that an event task holding a reference to an lvalue callable can be moved into a runner
+UTEST(EventTask, LvalueCallable) {
+    int events = 0;
+    auto count = [&events]() { events++; };
+    TaskRunner runner(create_event_task(count));
+    
+    runner.get_task<0>().signal();
+    runner.poll();
+    ASSERT_EQ(events, 1);
+}
+
+// Stateful functor with a large payload that counts its moves and detects calls on a moved-from copy
+struct ProbeFunctor {
+    static inline int moves = 0;
+    int* stale_calls;
+    int calls = 0;
+    bool moved_from = false;
+    uint8_t payload[128] = {};
+    
+    explicit ProbeFunctor(int* stale) : stale_calls(stale) {}
+    ProbeFunctor(ProbeFunctor&& other) : stale_calls(other.stale_calls), calls(other.calls) {
+        other.moved_from = true;
+        moves++;
+    }
+    
+    void operator()() {
+        if (moved_from) {
+            (*stale_calls)++;
+        } else {
+            calls++;
+        }
+    }
+};
+
+// Test that moved tasks dispatch through the runner's storage, not the moved-from objects
+UTEST(TaskRunner, NoStaleDispatchAfterMove) {
+    test_platform::SimulatedTime simulated_time;
+    int stale = 0;
+    // The moved-from tasks stay alive, so a stale worker pointer would call their functors
+    auto scheduled = create_scheduled_task(1, ProbeFunctor(&stale));
+    auto prioritized = create_scheduled_task(2, ProbeFunctor(&stale), SchedulePolicy::skip, 5);
+    auto fixed = create_scheduled_task<1>(ProbeFunctor(&stale));
+    auto event = create_event_task(ProbeFunctor(&stale));
+    TaskRunner runner(std::move(scheduled), std::move(prioritized), std::move(fixed), std::move(event));
+    runner.set_dispatch_mode(DispatchMode::priority);
+    
+    const absolute_time_t end = make_timeout_time_ms(10);
+    while (!time_reached(end)) {
+        runner.get_task<3>().signal();
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    ASSERT_EQ(stale, 0);
+    ASSERT_GE(runner.get_task<0>().get_callback().calls, 10);
+    ASSERT_GE(runner.get_task<1>().get_callback().calls, 5);
+    ASSERT_GE(runner.get_task<2>().get_callback().calls, 10);
+    ASSERT_EQ(scheduled.get_callback().calls, 0);
+    ASSERT_EQ(fixed.get_callback().calls, 0);
+}
+
+// Test that descriptors construct tasks in place, moving each functor once
+UTEST(TaskRunner, InPlaceDescriptors) {
+    test_platform::SimulatedTime simulated_time;
+    int stale = 0;
+    ProbeFunctor::moves = 0;
+    TaskRunner runner(task_descriptor(1, ProbeFunctor(&stale)),
+                      task_descriptor(std::chrono::microseconds{500}, ProbeFunctor(&stale), SchedulePolicy::skip, 3));
+    static_assert(std::is_same_v<decltype(runner), TaskRunner<ScheduledTask<ProbeFunctor>, ScheduledTask<ProbeFunctor>>>);
+    ASSERT_EQ(ProbeFunctor::moves, 2);
+    ASSERT_EQ(runner.get_task<1>().get_period().count(), 500);
+    ASSERT_TRUE(runner.get_task<1>().get_policy() == SchedulePolicy::skip);
+    ASSERT_EQ(runner.get_task<1>().get_priority(), 3);
+    
+    const absolute_time_t end = make_timeout_time_ms(10);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    ASSERT_EQ(stale, 0);
+    ASSERT_GE(runner.get_task<0>().get_callback().calls, 10);
+    ASSERT_GE(runner.get_task<1>().get_callback().calls, 20);
+    
+    // A task built first and moved in costs one more functor move, but no more
+    ProbeFunctor::moves = 0;
+    auto task = create_scheduled_task(1, ProbeFunctor(&stale));
+    TaskRunner moved_runner(std::move(task));
+    ASSERT_EQ(ProbeFunctor::moves, 2);
+}
+
+// Largest number of task runs in a single poll over one simulated second
+template<typename Runner>
+static int peak_runs_per_poll(Runner& runner, const int& runs) {
+    int peak = 0;
+    const absolute_time_t end = make_timeout_time_ms(1000);
+    while (!time_reached(end)) {
+        const int before = runs;
+        runner.poll();
+        peak = runs - before > peak ? runs - before : peak;
+        runner.wait_for_work_until(end);
+    }
+    return peak;
+}
+
+// Test that staggering spreads tasks with harmonic periods over separate ticks
+UTEST(TaskRunner, StaggerPhases) {
+    static_assert(stagger_offsets(std::array<uint64_t, 4>{100000, 200000, 500000, 1000000}, 1000) ==
+                  std::array<uint64_t, 4>{0, 1000, 2000, 3000});
+    // A 1ms task is due every tick, so nothing can avoid it; unperiodic entries stay put
+    static_assert(stagger_offsets(std::array<uint64_t, 3>{1000, 2000, 0}, 1000) == std::array<uint64_t, 3>{0, 0, 0});
+    
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    auto count = [&runs]() { runs++; };
+    {
+        TaskRunner runner(task_descriptor(1000, count, SchedulePolicy::skip), task_descriptor(500, count, SchedulePolicy::skip),
+                          task_descriptor(200, count, SchedulePolicy::skip), task_descriptor(100, count, SchedulePolicy::skip),
+                          create_event_task(count));
+        ASSERT_EQ(peak_runs_per_poll(runner, runs), 4);
+    }
+    {
+        TaskRunner runner(task_descriptor(1000, count, SchedulePolicy::skip), task_descriptor(500, count, SchedulePolicy::skip),
+                          task_descriptor(200, count, SchedulePolicy::skip), task_descriptor(100, count, SchedulePolicy::skip),
+                          create_event_task(count));
+        const absolute_time_t start = get_absolute_time();
+        runner.stagger();
+        ASSERT_EQ(runner.get_next_deadline(), start);
+        ASSERT_EQ(peak_runs_per_poll(runner, runs), 1);
+        // Shortest period first, then the 200, 500 and 1000ms tasks one tick later each
+        ASSERT_EQ(absolute_time_diff_us(start, runner.get_task<0>().get_native_worker().next_time) % 1000000, 3000);
+    }
+}
+
+// Violations reported to the timing hook
+static std::vector<TimingViolation> g_violations;
+
+static void record_violation(TimingViolation const& violation) {
+    g_violations.push_back(violation);
+}
+
+// Test that slow runs and late starts are reported to the timing hook with their measurements
+UTEST(TaskRunner, TimingHook) {
+    test_platform::SimulatedTime simulated_time;
+    g_violations.clear();
+    int slow_runs = 0;
+    // Every third run of the slow task takes 1.5ms; the control task is due with it and waits
+    auto slow = create_scheduled_task(5, [&slow_runs]() { busy_wait_us(++slow_runs % 3 == 0 ? 1500 : 300); }, SchedulePolicy::skip);
+    auto control = create_scheduled_task(5, []() { busy_wait_us(50); }, SchedulePolicy::skip);
+    auto unchecked = create_scheduled_task(5, []() { busy_wait_us(2000); }, SchedulePolicy::skip);
+    slow.set_execution_budget(std::chrono::microseconds{1000});
+    control.set_start_tolerance(std::chrono::microseconds{1000});
+    TaskRunner runner(std::move(slow), std::move(control), std::move(unchecked));
+    runner.set_timing_hook(&record_violation);
+    
+    const absolute_time_t end = make_timeout_time_ms(30);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    // Six releases: runs 3 and 6 of the slow task overrun and delay the control task
+    ASSERT_EQ(slow_runs, 6);
+    ASSERT_EQ(g_violations.size(), 4u);
+    for (size_t i = 0; i < g_violations.size(); i += 2) {
+        const TimingViolation& overrun = g_violations[i];
+        ASSERT_EQ(overrun.task_id, 0);
+        ASSERT_TRUE(overrun.overrun);
+        ASSERT_FALSE(overrun.late_start);
+        ASSERT_EQ(overrun.execution_us, 1500u);
+        ASSERT_EQ(overrun.lateness_us, 0);
+        
+        const TimingViolation& late = g_violations[i + 1];
+        ASSERT_EQ(late.task_id, 1);
+        ASSERT_FALSE(late.overrun);
+        ASSERT_TRUE(late.late_start);
+        ASSERT_EQ(late.execution_us, 50u);
+        ASSERT_EQ(late.lateness_us, 1500);
+    }
+    
+    // Without a hook nothing is checked
+    runner.set_timing_hook(nullptr);
+    g_violations.clear();
+    const absolute_time_t later = make_timeout_time_ms(30);
+    while (!time_reached(later)) {
+        runner.poll();
+        runner.wait_for_work_until(later);
+    }
+    ASSERT_EQ(g_violations.size(), 0u);
+}
+
+// Runs the runner loop for the given time
+template<typename... Tasks>
+static void run_loop_for_ms(TaskRunner<Tasks...>& runner, uint32_t ms) {
+    const absolute_time_t end = make_timeout_time_ms(ms);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+}
+
+// Test utilization figures against synthetic loads of known size
+UTEST(TaskRunner, CpuLoad) {
+    test_platform::SimulatedTime simulated_time;
+    uint32_t work_us = 3000;
+    auto load = create_scheduled_task(10, [&work_us]() { busy_wait_us(work_us); }, SchedulePolicy::skip);
+    TaskRunner runner(std::move(load));
+    runner.set_load_window(std::chrono::milliseconds{100}, 1);
+    
+    // 3ms of every 10ms
+    run_loop_for_ms(runner, 1000);
+    CpuLoad steady = runner.get_cpu_load();
+    // Reading the figures accounts the time up to now, which closes the window ending at 1s
+    ASSERT_EQ(steady.windows, 10u);
+    ASSERT_EQ(steady.busy_us + steady.idle_us, 1000000u);
+    ASSERT_EQ(steady.runs, 100u);
+    ASSERT_NEAR(steady.busy_us, 300000u, 10000u);
+    ASSERT_NEAR(steady.last_ppm, 300000u, 10000u);
+    ASSERT_NEAR(steady.average_ppm, 300000u, 10000u);
+    ASSERT_NEAR(steady.utilization(), 0.3f, 0.01f);
+    
+    // One window at 80%, then back to 30%: the peak keeps the burst
+    work_us = 8000;
+    run_loop_for_ms(runner, 100);
+    work_us = 3000;
+    run_loop_for_ms(runner, 1000);
+    CpuLoad burst = runner.get_cpu_load();
+    ASSERT_NEAR(burst.peak_ppm, 800000u, 10000u);
+    ASSERT_NEAR(burst.peak_utilization(), 0.8f, 0.01f);
+    ASSERT_NEAR(burst.average_ppm, 300000u, 10000u);
+    
+    // Idle: the average decays to zero without a poll per window
+    runner.get_task<0>().pause();
+    run_loop_for_ms(runner, 60000);
+    runner.poll();
+    CpuLoad idle = runner.get_cpu_load();
+    ASSERT_EQ(idle.last_ppm, 0u);
+    ASSERT_EQ(idle.average_ppm, 0u);
+    ASSERT_NEAR(idle.windows, burst.windows + 600u, 1u);
+    ASSERT_NEAR(idle.idle_us - burst.idle_us, 60000000u, 10000u);
+    
+    runner.reset_cpu_load();
+    ASSERT_EQ(runner.get_cpu_load().busy_us, 0u);
+    ASSERT_EQ(runner.get_cpu_load().peak_ppm, 0u);
+}
+
+// Test that spinning on poll() with nothing to run counts as idle
+UTEST(TaskRunner, CpuLoadIdleSpin) {
+    int runs = 0;
+    TaskRunner runner(create_scheduled_task(std::chrono::seconds{10}, [&runs]() { runs++; }),
+                      create_event_task([&runs]() {
+                          busy_wait_us(500);
+                          runs++;
+                      }));
+    // The periodic task runs once, then nothing is due for 10s
+    runner.poll();
+    runner.set_load_window(std::chrono::milliseconds{10}, 0);
+
+    const absolute_time_t end = make_timeout_time_ms(50);
+    while (!time_reached(end)) {
+        runner.poll();
+    }
+    CpuLoad idle = runner.get_cpu_load();
+    ASSERT_EQ(runs, 1);
+    ASSERT_GE(idle.windows, 4u);
+    ASSERT_EQ(idle.busy_us, 0u);
+    ASSERT_EQ(idle.runs, 0u);
+    ASSERT_EQ(idle.peak_ppm, 0u);
+    ASSERT_EQ(idle.average_ppm, 0u);
+
+    // A poll that runs a task is busy again
+    runner.get_task<1>().signal();
+    runner.poll();
+    ASSERT_EQ(runs, 2);
+    ASSERT_GE(runner.get_cpu_load().busy_us, 500u);
+    ASSERT_EQ(runner.get_cpu_load().runs, 1u);
+}
+
+#ifdef MAMETASK_ENABLE_STATS
+// Worst-case lateness of a 1ms control task competing with slow low-priority tasks
+static int64_t control_task_max_lateness_us(DispatchMode mode) {
+    test_platform::SimulatedTime simulated_time;
+    // Listed first so that FIFO order puts them ahead of the control task
+    auto print_task = create_scheduled_task(7, []() { busy_wait_us(800); }, SchedulePolicy::skip, 1);
+    auto log_task = create_scheduled_task(3, []() { busy_wait_us(300); }, SchedulePolicy::skip, 1);
+    auto ui_task = create_scheduled_task(5, []() { busy_wait_us(250); }, SchedulePolicy::skip, 2);
+    auto control_task = create_scheduled_task(1, []() { busy_wait_us(50); }, SchedulePolicy::skip, 10);
+    TaskRunner runner(std::move(print_task), std::move(log_task), std::move(ui_task), std::move(control_task));
+    runner.set_dispatch_mode(mode);
+    
+    const absolute_time_t end = make_timeout_time_ms(1000);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    return runner.get_task_stats<3>().max_lateness_us;
+}
+
+// Test that priority dispatch bounds the lateness of the high-priority task
+UTEST(TaskRunner, PriorityDispatchLateness) {
+    const int64_t fifo_lateness = control_task_max_lateness_us(DispatchMode::fifo);
+    const int64_t priority_lateness = control_task_max_lateness_us(DispatchMode::priority);
+    
+    // FIFO makes the control task wait behind every task due at the same time
+    ASSERT_GE(fifo_lateness, 800 + 300 + 250);
+    // With priorities it waits for at most one low-priority run that has already started
+    ASSERT_LE(priority_lateness, 800);
+    ASSERT_LT(priority_lateness, fifo_lateness);
+}
+#endif
+
+// Test that priority dispatch orders tasks that are due together
+UTEST(TaskRunner, PriorityDispatchOrder) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<int> order;
+    auto low = create_scheduled_task(10, [&order]() { order.push_back(0); }, SchedulePolicy::relative, 0);
+    auto high = create_scheduled_task(10, [&order]() { order.push_back(2); }, SchedulePolicy::relative, 200);
+    auto mid = create_scheduled_task(10, [&order]() { order.push_back(1); }, SchedulePolicy::relative, 100);
+    TaskRunner runner(std::move(low), std::move(high), std::move(mid));
+    ASSERT_TRUE(runner.get_dispatch_mode() == DispatchMode::fifo);
+    runner.set_dispatch_mode(DispatchMode::priority);
+    
+    runner.poll();
+    ASSERT_TRUE(order == std::vector<int>({2, 1, 0}));
+    
+    // Back in FIFO mode the context order applies, i.e. the order they were rescheduled in
+    runner.set_dispatch_mode(DispatchMode::fifo);
+    runner.wait_for_work_until(at_the_end_of_time);
+    runner.poll();
+    ASSERT_EQ(order.size(), 6u);
+    ASSERT_TRUE(std::vector<int>(order.begin() + 3, order.end()) == std::vector<int>({2, 1, 0}));
+}
+
+// Misses of a loose and a tight deadline task released together, for the given mode
+static std::pair<uint32_t, uint32_t> deadline_misses(DispatchMode mode, bool track = true) {
+    test_platform::SimulatedTime simulated_time;
+    auto telemetry = create_scheduled_task(10, []() { busy_wait_us(1500); }, SchedulePolicy::burst);
+    auto control = create_scheduled_task(10, []() { busy_wait_us(1500); }, SchedulePolicy::burst);
+    control.set_relative_deadline(std::chrono::milliseconds{2});
+    TaskRunner runner(std::move(telemetry), std::move(control));
+    runner.set_dispatch_mode(mode);
+    // EDF counts misses on its own; FIFO only when asked to
+    if (mode != DispatchMode::edf) {
+        runner.set_deadline_tracking(track);
+    }
+    
+    const absolute_time_t end = make_timeout_time_ms(100);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    return {runner.get_task<0>().get_deadline_misses(), runner.get_task<1>().get_deadline_misses()};
+}
+
+// Test that EDF dispatch runs the task with the earliest absolute deadline first
+UTEST(TaskRunner, EdfDispatch) {
+    auto control = create_scheduled_task(10, []() {});
+    ASSERT_EQ(control.get_relative_deadline().count(), 10000);
+    control.set_relative_deadline(std::chrono::microseconds{2500});
+    ASSERT_EQ(control.get_relative_deadline().count(), 2500);
+    
+    // FIFO runs the telemetry task first, so the control task misses every deadline
+    const auto fifo = deadline_misses(DispatchMode::fifo);
+    ASSERT_EQ(fifo.first, 0u);
+    ASSERT_EQ(fifo.second, 10u);
+    // Counting costs a timestamp per run, so it is off by default outside EDF
+    const auto untracked = deadline_misses(DispatchMode::fifo, false);
+    ASSERT_EQ(untracked.second, 0u);
+    
+    const auto edf = deadline_misses(DispatchMode::edf);
+    ASSERT_EQ(edf.first, 0u);
+    ASSERT_EQ(edf.second, 0u);
+}
+
+#ifdef PLATFORM_HOST
+// Test that signalling from another thread beats polling a flag from a 1ms task
+UTEST(EventTask, SignalLatencyFromThread) {
+    constexpr int signals = 50;
+    std::atomic<uint64_t> signalled_at{0};
+    std::atomic<bool> flag{false};
+    std::atomic<int> handled{0};
+    uint64_t event_latency_us = 0;
+    uint64_t polled_latency_us = 0;
+    int polled = 0;
+    
+    auto event_task = create_event_task([&]() {
+        event_latency_us += time_us_64() - signalled_at.load();
+        handled++;
+    });
+    auto polled_task = create_scheduled_task(1, [&]() {
+        if (flag.exchange(false)) {
+            polled_latency_us += time_us_64() - signalled_at.load();
+            polled++;
+        }
+    }, SchedulePolicy::skip);
+    TaskRunner runner(std::move(event_task), std::move(polled_task));
+    auto& event = runner.get_task<0>();
+    
+    std::thread producer([&]() {
+        for (int i = 0; i < signals; i++) {
+            // Wait until the previous signal has been served by both tasks
+            while (handled.load() < i || flag.load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(1700 + 300 * (i % 7)));
+            signalled_at = time_us_64();
+            flag = true;
+            event.signal();
+        }
+    });
+    const absolute_time_t end = make_timeout_time_ms(5000);
+    while ((handled.load() < signals || polled < signals) && !time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    producer.join();
+    
+    ASSERT_EQ(handled.load(), signals);
+    ASSERT_EQ(polled, signals);
+    // The event task reacts without waiting for a tick
+    ASSERT_LT(event_latency_us / signals, polled_latency_us / signals);
+}
+
+// Test that the virtual clock makes a simulated hour reproducible
+UTEST(VirtualClock, SimulatedHour) {
+    struct Hour {
+        uint64_t trace = 1469598103934665603ull;
+        int runs[4] = {};
+        uint64_t simulated_us = 0;
+    };
+    // Trace hash and run counts of one simulated hour of a mixed task set
+    auto simulate_hour = []() {
+        VirtualClock clock;
+        Hour hour;
+        auto record = [&](uint64_t id) {
+            hour.trace = (hour.trace ^ (id << 56 ^ clock.now())) * 1099511628211ull;
+            hour.runs[id - 1]++;
+        };
+        auto sensor = create_scheduled_task(std::chrono::milliseconds{10},
+                                            [&]() { record(1); busy_wait_us(700); },
+                                            SchedulePolicy::skip);
+        auto control = create_scheduled_task(std::chrono::microseconds{25500}, [&]() { record(2); busy_wait_us(30); });
+        auto telemetry = create_scheduled_task(1000, [&]() { record(3); busy_wait_us(4000); });
+        auto housekeeping = create_scheduled_task(std::chrono::minutes{1}, [&]() { record(4); });
+        TaskRunner runner(std::move(sensor), std::move(control), std::move(telemetry), std::move(housekeeping));
+        
+        const uint64_t start = clock.now();
+        const absolute_time_t end = delayed_by_us(start, 3600ull * 1000000);
+        while (clock.now() < end) {
+            runner.poll();
+            clock.advance_to_next_deadline(runner.get_native_context());
+        }
+        hour.simulated_us = clock.now() - start;
+        return hour;
+    };
+    
+    const Hour first = simulate_hour();
+    const Hour second = simulate_hour();
+    
+    // One simulated hour passed, whatever the wall time
+    ASSERT_GE(first.simulated_us, 3600ull * 1000000);
+    ASSERT_LT(first.simulated_us, 3600ull * 1000000 + 60000000);
+    // Every task ran about once per period; tasks on relative deadlines drift a little behind
+    const int nominal[4] = {360000, 141176, 3600, 60};
+    for (int i = 0; i < 4; i++) {
+        ASSERT_LE(first.runs[i], nominal[i] + 1);
+        ASSERT_GE(first.runs[i], nominal[i] - nominal[i] / 100);
+    }
+    // Both runs saw the same schedule
+    ASSERT_EQ(first.trace, second.trace);
+    ASSERT_EQ(first.simulated_us, second.simulated_us);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(first.runs[i], second.runs[i]);
+    }
+    
+    // The host clock is back in charge afterwards
+    ASSERT_EQ(mock_virtual_time_us(), nullptr);
+}
+
+// Test that the mock timer queue keeps insertion order for equal deadlines
+UTEST(AsyncContext, EqualDeadlinesKeepInsertionOrder) {
+    std::vector<int> execution_order;
+    struct OrderWorker {
+        async_at_time_worker_t worker{};
+        int id;
+        std::vector<int>* order;
+    };
+    std::vector<OrderWorker> workers;
+    for (int i = 0; i < 64; i++) {
+        workers.push_back({{}, i, &execution_order});
+    }
+    
+    async_context_poll_t context;
+    async_context_poll_init_with_defaults(&context);
+    for (auto& entry : workers) {
+        entry.worker.do_work = [](async_context_t*, async_at_time_worker_t* worker) {
+            auto* self = reinterpret_cast<OrderWorker*>(worker->user_data);
+            self->order->push_back(self->id);
+        };
+        entry.worker.user_data = &entry;
+        // Two distinct deadlines, interleaved
+        async_context_add_at_time_worker_at(&context.core, &entry.worker, entry.id % 2 ? 2 : 1);
+    }
+    
+    // Remove a worker from the middle of the queue
+    ASSERT_TRUE(async_context_remove_at_time_worker(&context.core, &workers[10].worker));
+    ASSERT_FALSE(async_context_remove_at_time_worker(&context.core, &workers[10].worker));
+    
+    async_context_poll(&context.core);
+    ASSERT_EQ(execution_order.size(), 63u);
+    
+    // Even ids (deadline 1) first, then odd ids, each in insertion order
+    std::vector<int> expected;
+    for (int i = 0; i < 64; i += 2) {
+        if (i != 10) expected.push_back(i);
+    }
+    for (int i = 1; i < 64; i += 2) {
+        expected.push_back(i);
+    }
+    ASSERT_TRUE(execution_order == expected);
+}
+
+// Test that, as in the SDK, a worker rescheduled into the past runs again in the same poll
+UTEST(AsyncContext, RescheduleIntoThePastRunsInSamePoll) {
+    struct CatchUpWorker {
+        async_at_time_worker_t worker{};
+        int runs = 0;
+    } entry;
+    entry.worker.do_work = [](async_context_t* context, async_at_time_worker_t* worker) {
+        auto* self = reinterpret_cast<CatchUpWorker*>(worker->user_data);
+        if (++self->runs < 3) {
+            async_context_add_at_time_worker_at(context, worker, 1);
+        }
+    };
+    entry.worker.user_data = &entry;
+
+    async_context_poll_t context;
+    async_context_poll_init_with_defaults(&context);
+    async_context_add_at_time_worker_at(&context.core, &entry.worker, 1);
+    async_context_poll(&context.core);
+    ASSERT_EQ(entry.runs, 3);
+    ASSERT_EQ(to_us_since_boot(context.core.next_time), to_us_since_boot(at_the_end_of_time));
+}
+
+// Test that adding a scheduled worker again is rejected but moves it to its new next_time, as in the SDK
+UTEST(AsyncContext, ReAddMovesDeadline) {
+    int runs[2] = {};
+    async_at_time_worker_t workers[2] = {};
+    for (int i = 0; i < 2; i++) {
+        workers[i].do_work = [](async_context_t*, async_at_time_worker_t* worker) {
+            (*static_cast<int*>(worker->user_data))++;
+        };
+        workers[i].user_data = &runs[i];
+    }
+
+    async_context_poll_t context;
+    async_context_poll_init_with_defaults(&context);
+    const absolute_time_t later = make_timeout_time_ms(1000);
+    ASSERT_TRUE(async_context_add_at_time_worker_at(&context.core, &workers[0], later));
+    ASSERT_TRUE(async_context_add_at_time_worker_at(&context.core, &workers[1], 1));
+
+    // Worker 0 becomes due now, worker 1 moves out
+    ASSERT_FALSE(async_context_add_at_time_worker_at(&context.core, &workers[0], 1));
+    ASSERT_FALSE(async_context_add_at_time_worker_at(&context.core, &workers[1], later));
+    ASSERT_EQ(to_us_since_boot(context.core.next_time), 1u);
+    async_context_poll(&context.core);
+    ASSERT_EQ(runs[0], 1);
+    ASSERT_EQ(runs[1], 0);
+    ASSERT_EQ(to_us_since_boot(context.core.next_time), to_us_since_boot(later));
+}
+#endif
+
 // Platform-specific tests
 #ifdef PLATFORM_DEVICE
 // Test running tasks on the device with LED blinking
@@ -0,0 +1,137 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskSchedulability.hpp"
+#include <array>
+
+// Four equal tasks at 80% utilization; above the Liu & Layland bound for n = 4
+static constexpr std::array<TaskTiming, 4> equal_tasks = {{
+    {.period_us = 10000, .wcet_us = 2000, .priority = 4},
+    {.period_us = 10000, .wcet_us = 2000, .priority = 3},
+    {.period_us = 10000, .wcet_us = 2000, .priority = 2},
+    {.period_us = 10000, .wcet_us = 2000, .priority = 1},
+}};
+
+// A fast task behind a long cooperative one; fine for a preemptive scheduler only
+static constexpr std::array<TaskTiming, 2> blocking_tasks = {{
+    {.period_us = 1000, .wcet_us = 100, .priority = 1},
+    {.period_us = 20000, .wcet_us = 5000, .priority = 0},
+}};
+
+// More work than time
+static constexpr std::array<TaskTiming, 2> overloaded_tasks = {{
+    {.period_us = 1000, .wcet_us = 600, .priority = 1},
+    {.period_us = 2000, .wcet_us = 1000, .priority = 0},
+}};
+
+static_assert(schedulability::fixed_priority(equal_tasks));
+static_assert(!schedulability::fixed_priority(blocking_tasks));
+static_assert(!schedulability::edf(overloaded_tasks));
+
+// Test the utilization based bounds
+UTEST(Schedulability, UtilizationBounds) {
+    static constexpr std::array<TaskTiming, 3> light_tasks = {{
+        {.period_us = 10000, .wcet_us = 1000, .priority = 3},
+        {.period_us = 20000, .wcet_us = 2000, .priority = 2},
+        {.period_us = 40000, .wcet_us = 4000, .priority = 1},
+    }};
+    ASSERT_NEAR(schedulability::utilization(light_tasks), 0.3, 1e-9);
+    ASSERT_TRUE(schedulability::liu_layland(light_tasks));
+    ASSERT_TRUE(schedulability::edf(light_tasks));
+
+    ASSERT_NEAR(schedulability::utilization(equal_tasks), 0.8, 1e-9);
+    ASSERT_FALSE(schedulability::liu_layland(equal_tasks));
+    ASSERT_TRUE(schedulability::edf(equal_tasks));
+
+    ASSERT_NEAR(schedulability::utilization(overloaded_tasks), 1.1, 1e-9);
+    ASSERT_FALSE(schedulability::liu_layland(overloaded_tasks));
+    ASSERT_FALSE(schedulability::edf(overloaded_tasks));
+
+    // Deadlines shorter than the period count against the EDF bound
+    static constexpr std::array<TaskTiming, 2> constrained_ok = {{
+        {.period_us = 10000, .wcet_us = 3000, .deadline_us = 5000},
+        {.period_us = 10000, .wcet_us = 3000},
+    }};
+    static constexpr std::array<TaskTiming, 2> constrained_too_tight = {{
+        {.period_us = 10000, .wcet_us = 3000, .deadline_us = 4000},
+        {.period_us = 10000, .wcet_us = 3000, .deadline_us = 4000},
+    }};
+    ASSERT_TRUE(schedulability::edf(constrained_ok));
+    ASSERT_FALSE(schedulability::edf(constrained_too_tight));
+}
+
+// Test response times under cooperative fixed-priority dispatch
+UTEST(Schedulability, ResponseTimeAnalysis) {
+    static constexpr std::array<TaskTiming, 3> tasks = {{
+        {.period_us = 10000, .wcet_us = 1000, .priority = 3},
+        {.period_us = 20000, .wcet_us = 2000, .priority = 2},
+        {.period_us = 40000, .wcet_us = 4000, .priority = 1},
+    }};
+    // Each task waits for the longest lower-priority run and all higher-priority releases
+    ASSERT_EQ(schedulability::response_time_us(tasks, 0), 5000u);
+    ASSERT_EQ(schedulability::response_time_us(tasks, 1), 7000u);
+    ASSERT_EQ(schedulability::response_time_us(tasks, 2), 11000u);
+    ASSERT_TRUE(schedulability::fixed_priority(tasks));
+
+    // Equal priorities are dispatched in task order
+    ASSERT_EQ(schedulability::response_time_us(equal_tasks, 3), 10000u);
+
+    // Passes the utilization bound, but the fast task can wait for a whole run of the slow one
+    ASSERT_TRUE(schedulability::liu_layland(blocking_tasks));
+    ASSERT_EQ(schedulability::response_time_us(blocking_tasks, 0), UINT64_MAX);
+    ASSERT_FALSE(schedulability::fixed_priority(blocking_tasks));
+    ASSERT_FALSE(schedulability::fixed_priority(overloaded_tasks));
+}
+
+// Test annotated tasks and the analysis of a runner type
+UTEST(Schedulability, AnnotatedRunner) {
+    auto control = create_timed_task<TaskTiming{.period_us = 1000, .wcet_us = 200, .deadline_us = 500, .priority = 2}>([]() {});
+    auto telemetry = annotate<TaskTiming{.period_us = 10000, .wcet_us = 300, .priority = 1}>(create_scheduled_task(10, []() {}));
+    auto command = annotate<TaskTiming{.period_us = 5000, .wcet_us = 100}>(create_event_task([]() {}));
+    ASSERT_EQ(control.get_period().count(), 1000);
+    ASSERT_EQ(control.get_relative_deadline().count(), 500);
+    ASSERT_EQ(control.get_priority(), 2);
+    ASSERT_EQ(telemetry.get_relative_deadline().count(), 10000);
+    ASSERT_EQ(telemetry.get_priority(), 1);
+
+    TaskRunner runner(std::move(control), std::move(telemetry), std::move(command));
+    using Analysis = TaskSetAnalysis<decltype(runner)>;
+    static_assert(Analysis::fixed_priority, "the example task set must stay schedulable");
+    ASSERT_NEAR(Analysis::utilization, 0.2 + 0.03 + 0.02, 1e-9);
+    ASSERT_TRUE(Analysis::liu_layland);
+    ASSERT_TRUE(Analysis::edf);
+}
+
+// Runs a task set whose runs take their WCET and returns the total number of deadline misses
+template<typename... Tasks>
+static uint32_t simulated_misses(TaskRunner<Tasks...>& runner) {
+    runner.set_dispatch_mode(DispatchMode::priority);
+    runner.set_deadline_tracking(true);
+    const absolute_time_t end = make_timeout_time_ms(100);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    return [&runner]<size_t... I>(std::index_sequence<I...>) {
+        return (runner.template get_task<I>().get_deadline_misses() + ...);
+    }(std::index_sequence_for<Tasks...>{});
+}
+
+// Test that the analysis agrees with the runner on simulated time
+UTEST(Schedulability, AgreesWithSimulation) {
+    test_platform::SimulatedTime simulated_time;
+    {
+        auto wcet = []() { busy_wait_us(2000); };
+        TaskRunner runner(create_timed_task<equal_tasks[0]>(wcet, SchedulePolicy::skip),
+                          create_timed_task<equal_tasks[1]>(wcet, SchedulePolicy::skip),
+                          create_timed_task<equal_tasks[2]>(wcet, SchedulePolicy::skip),
+                          create_timed_task<equal_tasks[3]>(wcet, SchedulePolicy::skip));
+        static_assert(TaskSetAnalysis<decltype(runner)>::fixed_priority);
+        ASSERT_EQ(simulated_misses(runner), 0u);
+    }
+    {
+        TaskRunner runner(create_timed_task<blocking_tasks[0]>([]() { busy_wait_us(100); }, SchedulePolicy::skip),
+                          create_timed_task<blocking_tasks[1]>([]() { busy_wait_us(5000); }, SchedulePolicy::skip));
+        static_assert(!TaskSetAnalysis<decltype(runner)>::fixed_priority);
+        ASSERT_GT(simulated_misses(runner), 0u);
+    }
+}
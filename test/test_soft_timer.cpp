@@ -0,0 +1,159 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskSoftTimer.hpp"
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+using Timers = SoftTimers<8>;
+
+// Times at which a timer expired
+static std::vector<uint64_t> g_expiries;
+
+static void record_expiry(void*) {
+    g_expiries.push_back(time_us_64());
+}
+
+// Runs the runner loop for the given time
+template<typename Runner>
+static void run_timers_for_ms(Runner& runner, uint32_t ms) {
+    const absolute_time_t end = make_timeout_time_ms(ms);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+}
+
+// Test that a timer fires once, on its deadline
+UTEST(SoftTimers, FiresOnce) {
+    test_platform::SimulatedTime simulated_time;
+    g_expiries.clear();
+    TaskRunner runner(Timers{});
+    Timers& timers = runner.get_task<0>();
+
+    SoftTimerHandle timeout = timers.create(&record_expiry);
+    ASSERT_TRUE(static_cast<bool>(timeout));
+    ASSERT_FALSE(timers.is_running(timeout));
+    const uint64_t start = time_us_64();
+    ASSERT_TRUE(timers.restart(timeout, 10ms));
+    ASSERT_TRUE(timers.is_running(timeout));
+
+    run_timers_for_ms(runner, 30);
+    ASSERT_EQ(g_expiries.size(), 1u);
+    ASSERT_GE(g_expiries[0] - start, 10000u);
+    ASSERT_LT(g_expiries[0] - start, 10000u + Timers::tick.count());
+    ASSERT_FALSE(timers.is_running(timeout));
+}
+
+// Test that restarting to a later deadline does not requeue the worker and postpones expiry
+UTEST(SoftTimers, RestartPostponesLazily) {
+    test_platform::SimulatedTime simulated_time;
+    g_expiries.clear();
+    TaskRunner runner(Timers{});
+    Timers& timers = runner.get_task<0>();
+    SoftTimerHandle inactivity = timers.create(&record_expiry);
+
+    timers.restart(inactivity, 10ms);
+    const absolute_time_t first_deadline = runner.get_next_deadline();
+    // A message every 3ms keeps the link alive
+    for (int i = 0; i < 3; i++) {
+        run_timers_for_ms(runner, 3);
+        timers.restart(inactivity, 10ms);
+        ASSERT_EQ(to_us_since_boot(runner.get_next_deadline()), to_us_since_boot(first_deadline));
+    }
+    const absolute_time_t last_restart = get_absolute_time();
+
+    // The old deadline passes without firing, then the timer expires 10ms after the last restart
+    run_timers_for_ms(runner, 30);
+    ASSERT_EQ(g_expiries.size(), 1u);
+    ASSERT_EQ(g_expiries[0], to_us_since_boot(delayed_by_ms(last_restart, 10)));
+}
+
+// Test that a negative delay is rejected and leaves the timer as it was
+UTEST(SoftTimers, NegativeDelay) {
+    test_platform::SimulatedTime simulated_time;
+    g_expiries.clear();
+    TaskRunner runner(Timers{});
+    Timers& timers = runner.get_task<0>();
+    SoftTimerHandle idle = timers.create(&record_expiry);
+    SoftTimerHandle running = timers.create(&record_expiry);
+
+    ASSERT_FALSE(timers.restart(idle, -1ms));
+    ASSERT_FALSE(timers.is_running(idle));
+    ASSERT_TRUE(timers.restart(running, 5ms));
+    ASSERT_FALSE(timers.restart(running, -1ms));
+    ASSERT_TRUE(timers.is_running(running));
+
+    run_timers_for_ms(runner, 10);
+    ASSERT_EQ(g_expiries.size(), 1u);
+}
+
+// Test restarting earlier, cancelling and running out of timers
+UTEST(SoftTimers, RestartEarlierAndCancel) {
+    test_platform::SimulatedTime simulated_time;
+    g_expiries.clear();
+    TaskRunner runner(SoftTimers<2>{});
+    auto& timers = runner.get_task<0>();
+    SoftTimerHandle ack = timers.create(&record_expiry);
+    SoftTimerHandle debounce = timers.create(&record_expiry);
+    ASSERT_FALSE(static_cast<bool>(timers.create(&record_expiry)));
+
+    const uint64_t start = time_us_64();
+    timers.restart(ack, 100ms);
+    timers.restart(ack, 5ms);
+    timers.restart(debounce, 20ms);
+    ASSERT_TRUE(timers.cancel(debounce));
+    ASSERT_FALSE(timers.cancel(debounce));
+    ASSERT_EQ(to_us_since_boot(timers.get_deadline(debounce)), to_us_since_boot(at_the_end_of_time));
+
+    run_timers_for_ms(runner, 200);
+    ASSERT_EQ(g_expiries.size(), 1u);
+    ASSERT_EQ(g_expiries[0] - start, 5000u);
+
+    // A destroyed timer frees its slot for the next create()
+    timers.destroy(debounce);
+    ASSERT_FALSE(timers.restart(debounce, 1ms));
+    ASSERT_TRUE(static_cast<bool>(timers.create(&record_expiry)));
+}
+
+// Retransmission state driven by a timer that restarts itself
+struct Retransmitter {
+    Timers* timers;
+    SoftTimerHandle timer;
+    int attempts = 0;
+
+    static void on_timeout(void* user_data) {
+        auto* self = static_cast<Retransmitter*>(user_data);
+        if (++self->attempts < 4) {
+            self->timers->restart(self->timer, 2ms);
+        } else {
+            self->timers->destroy(self->timer);
+        }
+    }
+};
+
+// Test that callbacks can restart and destroy their own timer
+UTEST(SoftTimers, RestartFromCallback) {
+    test_platform::SimulatedTime simulated_time;
+    TaskRunner runner(Timers{});
+    Retransmitter retransmitter{&runner.get_task<0>()};
+    retransmitter.timer = retransmitter.timers->create(&Retransmitter::on_timeout, &retransmitter);
+    retransmitter.timers->restart(retransmitter.timer, 2ms);
+
+    run_timers_for_ms(runner, 50);
+    ASSERT_EQ(retransmitter.attempts, 4);
+    ASSERT_FALSE(retransmitter.timers->restart(retransmitter.timer, 2ms));
+}
+
+// Test that running timers survive moving the timers into the runner
+UTEST(SoftTimers, StartBeforeAttach) {
+    test_platform::SimulatedTime simulated_time;
+    g_expiries.clear();
+    Timers timers;
+    SoftTimerHandle handle = timers.create(&record_expiry);
+    timers.restart(handle, 4ms);
+    TaskRunner runner(std::move(timers));
+    run_timers_for_ms(runner, 10);
+    ASSERT_EQ(g_expiries.size(), 1u);
+}
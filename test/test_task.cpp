@@ -1,6 +1,8 @@
 #include "utest.h"
 #include "platform.h"
 #include "../src/mameTaskPico.hpp"
+#include <vector>
+#include <functional>
 
 // Global counter for tests
 static int g_counter = 0;
@@ -228,6 +230,378 @@ UTEST(ScheduledTask, DynamicIntervalChange) {
     ASSERT_EQ(task.get_interval(), 200);
 }
 
+// Test that periods can be given as std::chrono durations
+UTEST(ScheduledTask, ChronoPeriod) {
+    auto ms_task = create_scheduled_task(100, []() {});
+    auto us_task = create_scheduled_task(std::chrono::microseconds{250}, []() {});
+    auto s_task = create_scheduled_task(std::chrono::seconds{2}, []() {});
+    
+    // The millisecond overload keeps its meaning
+    ASSERT_EQ(ms_task.get_interval(), 100u);
+    ASSERT_EQ(ms_task.get_period().count(), 100000);
+    
+    // Sub-millisecond periods are kept at microsecond resolution
+    ASSERT_EQ(us_task.get_period().count(), 250);
+    ASSERT_EQ(s_task.get_interval(), 2000u);
+}
+
+// Test that a sub-millisecond period is honoured by the runner
+UTEST(ScheduledTask, MicrosecondPeriod) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> times;
+    auto task = create_scheduled_task(std::chrono::microseconds{250},
+                                      [&times]() { times.push_back(time_us_64()); });
+    TaskRunner runner(std::move(task));
+    
+    // Run for 20ms
+    const absolute_time_t end = make_timeout_time_ms(20);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    // A 1ms period would have run at most 21 times
+    ASSERT_GE(times.size(), 40u);
+    ASSERT_LE(times.size(), 81u);
+    for (size_t i = 1; i < times.size(); i++) {
+        ASSERT_GE(times[i] - times[i - 1], 250u);
+    }
+}
+
+// Test that absolute deadlines accumulate no drift over many periods
+UTEST(ScheduledTask, DriftFreeDeadlines) {
+    test_platform::SimulatedTime simulated_time;
+    constexpr int periods = 10000;
+    constexpr uint64_t period_us = 20;
+    int runs = 0;
+    auto task = create_scheduled_task(std::chrono::microseconds{period_us},
+                                      [&runs]() { runs++; busy_wait_us(5); },
+                                      SchedulePolicy::burst);
+    TaskRunner runner(std::move(task));
+    
+    // Serve every deadline up to start + periods * period
+    const absolute_time_t start = runner.get_next_deadline();
+    const absolute_time_t end = delayed_by_us(start, periods * period_us);
+    while (runner.get_next_deadline() <= end) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    // Every deadline on the grid ran exactly once and the grid did not move
+    ASSERT_EQ(runs, periods + 1);
+    ASSERT_EQ(runner.get_next_deadline(), delayed_by_us(end, period_us));
+}
+
+// Test that relative rescheduling slips by the callback runtime
+UTEST(ScheduledTask, RelativeDeadlinesDrift) {
+    test_platform::SimulatedTime simulated_time;
+    constexpr int periods = 10000;
+    constexpr uint64_t period_us = 20;
+    int runs = 0;
+    auto task = create_scheduled_task(std::chrono::microseconds{period_us},
+                                      [&runs]() { runs++; busy_wait_us(5); });
+    TaskRunner runner(std::move(task));
+    
+    const absolute_time_t start = runner.get_next_deadline();
+    const absolute_time_t end = delayed_by_us(start, periods * period_us);
+    while (runner.get_next_deadline() <= end) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    // Each period lasted at least 25us, so fewer runs fit
+    ASSERT_LE(runs, periods * 20 / 25 + 1);
+#ifdef PLATFORM_HOST
+    // With simulated time every period lasts exactly 25us
+    ASSERT_EQ(runs, periods * 20 / 25 + 1);
+#endif
+}
+
+// Run a task's worker once as if it had been released for the given deadline
+template<typename Task>
+static absolute_time_t run_released_at(Task& task, absolute_time_t deadline) {
+    async_context_t context;
+    context.current_time_us = test_platform::time_us_64();
+    auto& worker = task.get_native_worker();
+    worker.next_time = deadline;
+    worker.do_work(&context, &worker);
+    return worker.next_time;
+}
+
+// Test the catch-up policies when deadlines have been missed
+UTEST(ScheduledTask, CatchUpPolicies) {
+    test_platform::SimulatedTime simulated_time;
+    constexpr uint64_t period_us = 1000;
+    const absolute_time_t now = get_absolute_time();
+    // Released 10.5 periods late
+    const absolute_time_t missed = now - 10 * period_us - period_us / 2;
+    
+    auto burst = create_scheduled_task(1, []() {}, SchedulePolicy::burst);
+    ASSERT_EQ(run_released_at(burst, missed), missed + period_us);
+    
+    // run_once resumes at the latest deadline that has passed, so it runs one more time now
+    auto run_once = create_scheduled_task(1, []() {}, SchedulePolicy::run_once);
+    absolute_time_t next = run_released_at(run_once, missed);
+    ASSERT_EQ((next - missed) % period_us, 0u);
+    ASSERT_LE(next, get_absolute_time());
+    ASSERT_GT(next + period_us, get_absolute_time());
+    
+    // skip resumes at the first deadline that has not passed yet
+    auto skip = create_scheduled_task(1, []() {}, SchedulePolicy::skip);
+    next = run_released_at(skip, missed);
+    ASSERT_EQ((next - missed) % period_us, 0u);
+    ASSERT_GE(next, now);
+    ASSERT_LE(next, get_absolute_time() + period_us);
+}
+
+// Test that a task holding a reference to an lvalue callable can be moved into a runner
+UTEST(ScheduledTask, LvalueCallable) {
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    auto count = [&runs]() { runs++; };
+    TaskRunner runner(create_scheduled_task(1, count));
+    
+    test_platform::sleep_ms(1);
+    runner.poll();
+    ASSERT_EQ(runs, 1);
+}
+
+#ifdef MAMETASK_ENABLE_STATS
+// Test that the runner exposes per-task execution time, lateness and overruns
+UTEST(ScheduledTask, RuntimeStatistics) {
+    test_platform::SimulatedTime simulated_time;
+    int runs = 0;
+    // Alternates between 100us and 300us of work
+    auto light = create_scheduled_task(std::chrono::milliseconds{1},
+                                       [&runs]() { busy_wait_us(runs++ % 2 ? 300 : 100); },
+                                       SchedulePolicy::skip);
+    // Overruns its 1ms period every time and delays the light task
+    auto heavy = create_scheduled_task(std::chrono::milliseconds{1},
+                                       []() { busy_wait_us(1500); },
+                                       SchedulePolicy::skip);
+    TaskRunner runner(std::move(light), std::move(heavy));
+    
+    const absolute_time_t end = make_timeout_time_ms(20);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    const TaskStats& light_stats = runner.get_task_stats<0>();
+    const TaskStats& heavy_stats = runner.get_task_stats<1>();
+    ASSERT_EQ(light_stats.run_count, static_cast<uint32_t>(runs));
+    ASSERT_GT(light_stats.run_count, 5u);
+    ASSERT_GT(heavy_stats.run_count, 5u);
+    ASSERT_GE(light_stats.min_execution_us, 100u);
+    ASSERT_GE(light_stats.max_execution_us, 300u);
+    ASSERT_GE(light_stats.mean_execution_us(), 100u);
+    ASSERT_LE(light_stats.mean_execution_us(), light_stats.max_execution_us);
+    ASSERT_EQ(heavy_stats.overrun_count, heavy_stats.run_count);
+    // Each task delays the other when they share a deadline
+    ASSERT_GT(light_stats.max_lateness_us, 0);
+    ASSERT_GT(heavy_stats.max_lateness_us, 0);
+#ifdef PLATFORM_HOST
+    // Simulated time makes the figures exact
+    ASSERT_EQ(light_stats.min_execution_us, 100u);
+    ASSERT_EQ(light_stats.max_execution_us, 300u);
+    ASSERT_EQ(heavy_stats.min_execution_us, 1500u);
+    ASSERT_EQ(heavy_stats.max_lateness_us, 100);
+    ASSERT_EQ(light_stats.max_lateness_us, 1500);
+    // Waiting for the heavy task makes the light one finish past its next deadline too
+    ASSERT_EQ(light_stats.overrun_count, light_stats.run_count - 2);
+#endif
+}
+#endif
+
+// Polls a runner on simulated time for the given number of milliseconds
+template<typename Runner>
+static void run_for_ms(Runner& runner, unsigned ms) {
+    const absolute_time_t end = make_timeout_time_ms(ms);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+}
+
+// Test pausing and resuming a task, from outside and from its own callback
+UTEST(ScheduledTask, PauseResume) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> times;
+    TaskRunner runner(create_scheduled_task(1, [&times]() { times.push_back(time_us_64()); }, SchedulePolicy::skip));
+    auto& task = runner.get_task<0>();
+    run_for_ms(runner, 5);
+    ASSERT_EQ(times.size(), 5u);
+    
+    // A paused task leaves nothing for the loop to wake up for
+    task.pause();
+    ASSERT_TRUE(task.is_paused());
+    ASSERT_EQ(runner.get_next_deadline(), at_the_end_of_time);
+    run_for_ms(runner, 10);
+    ASSERT_EQ(times.size(), 5u);
+    
+    // Resuming runs it on the next poll and then every period
+    const uint64_t resumed_at = time_us_64();
+    task.resume();
+    ASSERT_FALSE(task.is_paused());
+    run_for_ms(runner, 5);
+    ASSERT_EQ(times[5], resumed_at);
+    ASSERT_EQ(times.size(), 10u);
+    
+    // Resuming a running task changes nothing
+    task.resume();
+    run_for_ms(runner, 1);
+    ASSERT_EQ(times.size(), 11u);
+}
+
+// Test that a task can stop itself, and that a paused task does not run from the ready set
+UTEST(ScheduledTask, PauseFromCallbacks) {
+    test_platform::SimulatedTime simulated_time;
+    int self_runs = 0;
+    int low_runs = 0;
+    ScheduledTask<std::function<void()>>* self_task = nullptr;
+    ScheduledTask<std::function<void()>>* low_task = nullptr;
+    TaskRunner runner(create_scheduled_task(1, std::function<void()>([&]() {
+                          if (++self_runs == 3) {
+                              self_task->pause();
+                          }
+                      })),
+                      create_scheduled_task(2, std::function<void()>([&]() { low_runs++; }), SchedulePolicy::skip, 1),
+                      create_scheduled_task(2, std::function<void()>([&]() { low_task->pause(); }), SchedulePolicy::skip, 2));
+    self_task = &runner.get_task<0>();
+    low_task = &runner.get_task<1>();
+    runner.set_dispatch_mode(DispatchMode::priority);
+    
+    // The low-priority task is due together with the one that pauses it
+    run_for_ms(runner, 10);
+    ASSERT_EQ(self_runs, 3);
+    ASSERT_TRUE(self_task->is_paused());
+    ASSERT_EQ(low_runs, 0);
+    ASSERT_TRUE(low_task->is_paused());
+}
+
+// Test one-shot and N-shot runs
+UTEST(ScheduledTask, OneShotAndNShot) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> times;
+    auto task = create_scheduled_task(1, [&times]() { times.push_back(time_us_64()); });
+    
+    // Before the task is attached, the delay counts from the call
+    const uint64_t start = time_us_64();
+    task.run_once_after(3);
+    TaskRunner runner(std::move(task));
+    auto& runner_task = runner.get_task<0>();
+    run_for_ms(runner, 10);
+    ASSERT_EQ(times.size(), 1u);
+    ASSERT_EQ(times[0] - start, 3000u);
+    ASSERT_TRUE(runner_task.is_paused());
+    
+    // A one-shot while running replaces the periodic schedule
+    runner_task.resume();
+    runner.poll();
+    ASSERT_EQ(times.size(), 2u);
+    const uint64_t armed_at = time_us_64();
+    runner_task.run_once_after(5);
+    run_for_ms(runner, 10);
+    ASSERT_EQ(times.size(), 3u);
+    ASSERT_EQ(times[2] - armed_at, 5000u);
+    
+    // N runs on the regular schedule, then the task stops
+    runner_task.run_n_times(4);
+    ASSERT_EQ(runner_task.get_remaining_runs(), 4u);
+    run_for_ms(runner, 2);
+    ASSERT_EQ(runner_task.get_remaining_runs(), 2u);
+    run_for_ms(runner, 10);
+    ASSERT_EQ(times.size(), 7u);
+    ASSERT_TRUE(runner_task.is_paused());
+    ASSERT_EQ(runner_task.get_remaining_runs(), 0u);
+    ASSERT_EQ(runner.get_next_deadline(), at_the_end_of_time);
+    
+    // run_n_times(0) pauses
+    runner_task.resume();
+    runner_task.run_n_times(0);
+    run_for_ms(runner, 5);
+    ASSERT_EQ(times.size(), 7u);
+}
+
+// Test changing the period of a running task
+UTEST(ScheduledTask, SetInterval) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> times;
+    TaskRunner runner(create_scheduled_task(1, [&times]() { times.push_back(time_us_64()); }, SchedulePolicy::skip));
+    auto& task = runner.get_task<0>();
+    run_for_ms(runner, 3);
+    
+    task.set_interval(4);
+    ASSERT_EQ(task.get_interval(), 4u);
+    ASSERT_EQ(task.get_relative_deadline().count(), 4000);
+    run_for_ms(runner, 20);
+    
+    // The pending run keeps its time; later ones are 4ms apart
+    const size_t n = times.size();
+    ASSERT_EQ(times[n - 1] - times[n - 2], 4000u);
+    ASSERT_EQ(times[4] - times[3], 4000u);
+    ASSERT_EQ(times[3] - times[2], 1000u);
+    
+    // An explicitly tightened deadline is kept
+    task.set_relative_deadline(std::chrono::microseconds{500});
+    task.set_period(std::chrono::microseconds{2500});
+    ASSERT_EQ(task.get_period().count(), 2500);
+    ASSERT_EQ(task.get_relative_deadline().count(), 500);
+}
+
+// Test that compile-time intervals are part of the task type
+UTEST(FixedPeriodTask, CompileTimePeriod) {
+    auto ms_task = create_scheduled_task<500>([]() {});
+    auto us_task = create_scheduled_task<250, SchedulePolicy::skip, std::chrono::microseconds>([]() {});
+    static_assert(decltype(ms_task)::get_period().count() == 500000);
+    static_assert(decltype(us_task)::get_policy() == SchedulePolicy::skip);
+    ASSERT_EQ(ms_task.get_interval(), 500u);
+    ASSERT_EQ(us_task.get_period().count(), 250);
+    
+    // Only the worker and the callback are stored
+    ASSERT_LT(sizeof(ms_task), sizeof(create_scheduled_task(500, []() {})));
+}
+
+// Test that the load meter sees the runs of a task that does not report them
+UTEST(FixedPeriodTask, CpuLoad) {
+    test_platform::SimulatedTime simulated_time;
+    TaskRunner runner(create_scheduled_task<10, SchedulePolicy::skip>([]() { busy_wait_us(2000); }));
+    runner.poll();
+    runner.reset_cpu_load();
+
+    // Polls with nothing due in between count as idle
+    const absolute_time_t end = make_timeout_time_ms(100);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    CpuLoad const& load = runner.get_cpu_load();
+    ASSERT_EQ(load.runs, 10u);
+    ASSERT_NEAR(load.busy_us, 20000u, 1000u);
+}
+
+// Test that a fixed-period task keeps its grid and runs alongside other tasks
+UTEST(FixedPeriodTask, RunsAtPeriod) {
+    test_platform::SimulatedTime simulated_time;
+    std::vector<uint64_t> times;
+    int other_runs = 0;
+    auto record = [&times]() { times.push_back(time_us_64()); };
+    TaskRunner runner(create_scheduled_task<250, SchedulePolicy::burst, std::chrono::microseconds>(record),
+                      create_scheduled_task(1, [&other_runs]() { other_runs++; busy_wait_us(100); }));
+    
+    const absolute_time_t end = make_timeout_time_ms(20);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    // Runs delayed by the other task catch up on the original grid
+    ASSERT_EQ(times.size(), 80u);
+    ASSERT_EQ(times.back() - times.front(), 79u * 250u);
+    ASSERT_GT(other_runs, 0);
+}
+
 // Platform-specific tests
 #ifdef PLATFORM_DEVICE
 // Test using actual GPIO on the device
@@ -0,0 +1,173 @@
+#include "utest.h"
+#include "platform.h"
+#include "../src/mameTaskTimingWheel.hpp"
+#include <memory>
+#include <vector>
+
+// Timer node that records the tick at which it expired
+struct RecordingNode : TimingWheel::Node {
+    uint64_t fired_at = TimingWheel::never;
+    uint64_t fired_after = 0;
+    int fire_count = 0;
+};
+
+// Deterministic pseudo random numbers
+static uint64_t next_random(uint64_t& state) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+}
+
+// Test that every timer expires on the first advance that reaches it, on every level
+UTEST(TimingWheel, ExpiresExactlyAcrossLevels) {
+    constexpr size_t count = 2000;
+    auto nodes = std::make_unique<RecordingNode[]>(count);
+    TimingWheel wheel(12345);
+    uint64_t seed = 7;
+    
+    // Spread expiries over all levels and the overflow list
+    for (size_t i = 0; i < count; i++) {
+        const unsigned bits = 1 + next_random(seed) % 27;
+        wheel.insert(nodes[i], wheel.get_current_tick() + 1 + next_random(seed) % (uint64_t(1) << bits));
+    }
+    
+    // Cancel every fourth timer
+    for (size_t i = 0; i < count; i += 4) {
+        wheel.remove(nodes[i]);
+        ASSERT_FALSE(TimingWheel::is_scheduled(nodes[i]));
+    }
+    ASSERT_EQ(wheel.size(), count - count / 4);
+    
+    uint64_t previous = wheel.get_current_tick();
+    while (wheel.size() > 0) {
+        const uint64_t to = previous + 1 + next_random(seed) % 100000;
+        wheel.advance(to, [to, previous](TimingWheel::Node& node) {
+            auto& recording = static_cast<RecordingNode&>(node);
+            recording.fired_at = to;
+            recording.fired_after = previous;
+            recording.fire_count++;
+        });
+        previous = to;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (i % 4 == 0) {
+            ASSERT_EQ(nodes[i].fire_count, 0);
+            continue;
+        }
+        ASSERT_EQ(nodes[i].fire_count, 1);
+        // Fired by the first advance whose target reached the expiry
+        ASSERT_GE(nodes[i].fired_at, nodes[i].expiry);
+        ASSERT_LT(nodes[i].fired_after, nodes[i].expiry);
+    }
+}
+
+// Test expiry order and the next event lower bound
+UTEST(TimingWheel, ExpiryOrder) {
+    RecordingNode nodes[6];
+    TimingWheel wheel(0);
+    const uint64_t expiries[6] = {5000, 70, 70, 3, 5000, 70};
+    for (int i = 0; i < 6; i++) {
+        wheel.insert(nodes[i], expiries[i]);
+    }
+    ASSERT_EQ(wheel.next_event_tick(), 3u);
+    
+    std::vector<int> order;
+    wheel.advance(10000, [&](TimingWheel::Node& node) {
+        order.push_back(static_cast<int>(static_cast<RecordingNode*>(&node) - nodes));
+    });
+    
+    // Earlier expiries first, insertion order among equal expiries
+    const std::vector<int> expected = {3, 1, 2, 5, 0, 4};
+    ASSERT_TRUE(order == expected);
+    ASSERT_EQ(wheel.next_event_tick(), TimingWheel::never);
+}
+
+// Test that a node rescheduled from its callback expires on a later advance
+UTEST(TimingWheel, RescheduleFromCallback) {
+    RecordingNode node;
+    TimingWheel wheel(0);
+    wheel.insert(node, 10);
+    
+    int fired = 0;
+    for (uint64_t to = 10; to <= 100; to += 10) {
+        wheel.advance(to, [&](TimingWheel::Node& expired) {
+            fired++;
+            // Overdue reschedules must not loop within one advance
+            wheel.insert(expired, 0);
+        });
+    }
+    ASSERT_EQ(fired, 10);
+}
+
+// Test the wheel as the scheduler backend of a TaskRunner
+UTEST(TimingWheelContext, TaskRunnerBackend) {
+    test_platform::SimulatedTime simulated_time;
+    auto context = std::make_unique<TimingWheelContext<16>>();
+    int fast_runs = 0;
+    int slow_runs = 0;
+    auto fast_task = create_scheduled_task(5, [&fast_runs]() { fast_runs++; });
+    auto slow_task = create_scheduled_task(20, [&slow_runs]() { slow_runs++; });
+    TaskRunner runner(context->get_native_context(), std::move(fast_task), std::move(slow_task));
+    ASSERT_EQ(context->size(), 2u);
+    
+    const absolute_time_t end = make_timeout_time_ms(50);
+    while (!time_reached(end)) {
+        runner.poll();
+        runner.wait_for_work_until(end);
+    }
+    
+    ASSERT_GE(fast_runs, 5);
+    ASSERT_LE(fast_runs, 11);
+    ASSERT_GE(slow_runs, 2);
+    ASSERT_LE(slow_runs, 3);
+#ifdef PLATFORM_HOST
+    // Simulated time is exact: 0, 5, ..., 45ms and 0, 20, 40ms
+    ASSERT_EQ(fast_runs, 10);
+    ASSERT_EQ(slow_runs, 3);
+#endif
+    ASSERT_EQ(context->size(), 2u);
+}
+
+// Test adding and removing workers through the SDK API
+UTEST(TimingWheelContext, AddRemoveWorkers) {
+    auto context = std::make_unique<TimingWheelContext<2>>();
+    async_context_t* core = &context->get_native_context();
+    async_at_time_worker_t workers[3] = {};
+    
+    ASSERT_TRUE(async_context_add_at_time_worker_in_ms(core, &workers[0], 1000));
+    ASSERT_FALSE(async_context_add_at_time_worker_in_ms(core, &workers[0], 1000));
+    ASSERT_TRUE(async_context_add_at_time_worker_in_ms(core, &workers[1], 10));
+    
+    // Capacity is exhausted
+    ASSERT_FALSE(async_context_add_at_time_worker_in_ms(core, &workers[2], 10));
+    ASSERT_LE(core->next_time, make_timeout_time_ms(10) + 1000);
+    
+    ASSERT_TRUE(async_context_remove_at_time_worker(core, &workers[1]));
+    ASSERT_FALSE(async_context_remove_at_time_worker(core, &workers[1]));
+    ASSERT_TRUE(async_context_add_at_time_worker_in_ms(core, &workers[2], 10));
+    ASSERT_EQ(context->size(), 2u);
+}
+
+// Test that event tasks work on the wheel backend
+UTEST(TimingWheelContext, EventTask) {
+    test_platform::SimulatedTime simulated_time;
+    auto context = std::make_unique<TimingWheelContext<4>>();
+    int events = 0;
+    auto event_task = create_event_task([&events]() { events++; });
+    auto idle_task = create_scheduled_task(1000, []() {});
+    TaskRunner runner(context->get_native_context(), std::move(event_task), std::move(idle_task));
+    
+    runner.poll();
+    ASSERT_EQ(events, 0);
+    runner.get_task<0>().signal();
+    const absolute_time_t signalled_at = get_absolute_time();
+    runner.wait_for_work_until(at_the_end_of_time);
+    ASSERT_EQ(get_absolute_time(), signalled_at);
+    runner.poll();
+    ASSERT_EQ(events, 1);
+    
+    // Without a signal the loop sleeps towards the periodic task
+    runner.wait_for_work_until(at_the_end_of_time);
+    ASSERT_GT(get_absolute_time(), signalled_at);
+    ASSERT_EQ(events, 1);
+}